@@ -4,7 +4,7 @@
 #include "AboutWindow.h"
 
 AboutWindow::AboutWindow()
-    : mLibrariesCodeBrowser(Sources::imguiManualLibrary(), "imgui_manual/ImGuiManual.cpp")
+    : mLibrariesCodeBrowser("AboutWindow", Sources::imguiManualLibrary(), "imgui_manual/ImGuiManual.cpp")
 {
 }
 
@@ -19,14 +19,14 @@ void AboutWindow::guiHelp()
     static bool showHelp = true;
     if (showHelp)
     {
-        std::string help = R"(
+        const char *help = R"(
 This interactive manual was developed using [Hello ImGui](https://github.com/pthom/hello_imgui), which provided the emscripten port, as well as the assets embedding and image loading. ImGuiManual.cpp gives a good overview of [Hello Imgui API](https://github.com/pthom/hello_imgui/blob/master/src/hello_imgui/hello_imgui_api.md).
 
 See also a [related demo for Implot](https://traineq.org/implot_demo/src/implot_demo.html), which also provides code navigation.
 
 [I'd love to read your feedback!](https://github.com/pthom/imgui_manual/issues/1)
 )";
-        MarkdownHelper::Markdown(help.c_str());
+        MarkdownHelper::Markdown(help);
         if (ImGui::Button(ICON_FA_THUMBS_UP " Got it"))
             showHelp = false;
     }
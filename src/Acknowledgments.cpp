@@ -5,7 +5,7 @@
 #include "Acknowledgments.h"
 
 Acknowledgments::Acknowledgments()
-    : mLibrariesCodeBrowser(Sources::acknowldegmentLibraries(), "")
+    : mLibrariesCodeBrowser("Acknowledgments", Sources::acknowldegmentLibraries(), "")
 {
 }
 
@@ -20,8 +20,8 @@ void Acknowledgments::guiHelp()
     static bool showHelp = true;
     if (showHelp)
     {
-        std::string help = "This manual uses some great libraries, which are shown below.";
-        MarkdownHelper::Markdown(help.c_str());
+        const char *help = "This manual uses some great libraries, which are shown below.";
+        MarkdownHelper::Markdown(help);
         ImGui::SameLine();
         if (ImGui::Button(ICON_FA_THUMBS_UP " Got it"))
             showHelp = false;
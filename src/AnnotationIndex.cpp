@@ -0,0 +1,67 @@
+#include "AnnotationIndex.h"
+#include "utilities/Checksum.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace Sources
+{
+namespace
+{
+    constexpr std::string_view kIndexHeader = "# imgui_manual annotation index v1";
+
+    // Reads the next line of text (without its '\n') and advances text after it
+    bool nextLine(std::string_view &text, std::string_view *line)
+    {
+        if (text.empty())
+            return false;
+        size_t lineEnd = text.find('\n');
+        if (lineEnd == std::string_view::npos)
+            lineEnd = text.size();
+        *line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == text.size() ? lineEnd : lineEnd + 1);
+        return true;
+    }
+
+    bool isIndexUpToDate(std::string_view cksumLine, std::string_view sourceCode)
+    {
+        // cksumLine is "cksum <crc> <size>"
+        std::string line(cksumLine);
+        unsigned long crc = 0;
+        unsigned long long size = 0;
+        if (sscanf(line.c_str(), "cksum %lu %llu", &crc, &size) != 2)
+            return false;
+        if (size != sourceCode.size())
+            return false;
+        return crc == Checksum::PosixCksum(sourceCode.data(), sourceCode.size());
+    }
+}
+
+bool LoadAnnotationIndex(const Source &source,
+                         LineWithTag (*makeLineWithTag)(int lineNumber, std::string_view tag),
+                         LinesWithTags *linesWithTags)
+{
+    auto indexBuffer = SourceBuffer::TryFromAsset("code/" + source.sourcePath + ".tags");
+    if (!indexBuffer)
+        return false;
+    std::string_view index = indexBuffer->view();
+
+    std::string_view line;
+    if (!nextLine(index, &line) || line != kIndexHeader)
+        return false;
+    if (!nextLine(index, &line) || !isIndexUpToDate(line, source.sourceCode))
+        return false;
+
+    LinesWithTags r;
+    while (nextLine(index, &line))
+    {
+        size_t tab = line.find('\t');
+        if (tab == std::string_view::npos)
+            return false;
+        int lineNumber = atoi(std::string(line.substr(0, tab)).c_str());
+        r.push_back(makeLineWithTag(lineNumber, line.substr(tab + 1)));
+    }
+    *linesWithTags = std::move(r);
+    return true;
+}
+} // namespace Sources
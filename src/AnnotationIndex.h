@@ -0,0 +1,15 @@
+#pragma once
+#include "Sources.h"
+
+// Annotation indexes are produced at build time by make_annotation_index.sh
+// (called by populate_assets.sh): for a source such as "imgui/imgui_demo.cpp",
+// the asset "code/imgui/imgui_demo.cpp.tags" contains its tags.
+namespace Sources
+{
+// Fills linesWithTags from the index of source, and returns true.
+// Returns false if the index is missing, or stale (i.e. it was made for another version of the source)
+// makeLineWithTag builds each entry (e.g. MakeDocLineWithTag for the doc inside imgui.cpp, see TagScanner.h)
+bool LoadAnnotationIndex(const Source &source,
+                         LineWithTag (*makeLineWithTag)(int lineNumber, std::string_view tag),
+                         LinesWithTags *linesWithTags);
+}
@@ -0,0 +1,199 @@
+#include "AssetPack.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string_view>
+
+namespace AssetPack
+{
+    namespace
+    {
+        // Keep in sync with pack_assets.py
+        constexpr std::string_view kPackAssetPath = "code.pack";
+        constexpr std::string_view kPackedAssetsPrefix = "code/";
+        constexpr std::string_view kMagic = "IMGUIPAK";
+        constexpr uint32_t kVersion = 1;
+
+        struct Entry
+        {
+            uint32_t offset, compressedSize, size;
+        };
+
+        struct Pack
+        {
+            std::shared_ptr<const SourceBuffer> buffer;
+            std::map<std::string, Entry, std::less<>> entryOfPath; // paths are relative to "code/"
+        };
+
+        std::atomic<int> gNbDecompressions{0};
+
+        // Reads the header of the pack, and advances data after what was read
+        class HeaderReader
+        {
+        public:
+            explicit HeaderReader(std::string_view data) : mData(data) {}
+
+            bool read(void *dst, size_t nbBytes)
+            {
+                if (mData.size() < nbBytes)
+                    return false;
+                memcpy(dst, mData.data(), nbBytes);
+                mData.remove_prefix(nbBytes);
+                return true;
+            }
+            // Little endian integers
+            template <typename Int>
+            bool readInt(Int *value)
+            {
+                unsigned char bytes[sizeof(Int)];
+                if (!read(bytes, sizeof(Int)))
+                    return false;
+                *value = 0;
+                for (size_t i = 0; i < sizeof(Int); ++i)
+                    *value |= (Int)((Int)bytes[i] << (8 * i));
+                return true;
+            }
+
+        private:
+            std::string_view mData;
+        };
+
+        bool ReadPackHeader(Pack *pack)
+        {
+            std::string_view data = pack->buffer->view();
+            HeaderReader reader(data);
+            char magic[kMagic.size()];
+            uint32_t version = 0, nbEntries = 0;
+            if (!reader.read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) != kMagic)
+                return false;
+            if (!reader.readInt(&version) || version != kVersion || !reader.readInt(&nbEntries))
+                return false;
+            for (uint32_t i = 0; i < nbEntries; ++i)
+            {
+                uint16_t pathSize = 0;
+                if (!reader.readInt(&pathSize))
+                    return false;
+                std::string path(pathSize, '\0');
+                Entry entry;
+                if (!reader.read(&path[0], pathSize) || !reader.readInt(&entry.offset)
+                    || !reader.readInt(&entry.compressedSize) || !reader.readInt(&entry.size))
+                    return false;
+                if ((uint64_t)entry.offset + entry.compressedSize > data.size())
+                    return false;
+                pack->entryOfPath[path] = entry;
+            }
+            return true;
+        }
+
+        Pack LoadPack()
+        {
+            Pack r;
+            r.buffer = SourceBuffer::TryFromAssetFile(std::string(kPackAssetPath));
+            if (r.buffer && !ReadPackHeader(&r))
+            {
+                fprintf(stderr, "AssetPack: %s is invalid, it is ignored\n", kPackAssetPath.data());
+                r = Pack();
+            }
+            return r;
+        }
+
+        const Pack &GetPack()
+        {
+            static const Pack pack = LoadPack(); // thread safe initialization
+            return pack;
+        }
+
+        // Reads a length which did not fit into the 4 bits of a token
+        bool ReadLength(const uint8_t **ip, const uint8_t *ipEnd, size_t *length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (*ip >= ipEnd)
+                    return false;
+                byte = *(*ip)++;
+                *length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        // Decompresses a LZ4 block (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+        // into dst, whose size shall be the exact decompressed size. Returns false if the block is corrupt.
+        bool Lz4DecompressBlock(const uint8_t *src, size_t srcSize, char *dst, size_t dstSize)
+        {
+            const uint8_t *ip = src, *ipEnd = src + srcSize;
+            char *op = dst, *opEnd = dst + dstSize;
+            while (ip < ipEnd)
+            {
+                uint8_t token = *ip++;
+                size_t nbLiterals = token >> 4;
+                if (nbLiterals == 15 && !ReadLength(&ip, ipEnd, &nbLiterals))
+                    return false;
+                if (nbLiterals > (size_t)(ipEnd - ip) || nbLiterals > (size_t)(opEnd - op))
+                    return false;
+                memcpy(op, ip, nbLiterals);
+                ip += nbLiterals;
+                op += nbLiterals;
+                // The last sequence has only literals
+                if (ip == ipEnd)
+                    break;
+
+                if (ipEnd - ip < 2)
+                    return false;
+                size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+                ip += 2;
+                if (offset == 0 || offset > (size_t)(op - dst))
+                    return false;
+                size_t matchLength = token & 15;
+                if (matchLength == 15 && !ReadLength(&ip, ipEnd, &matchLength))
+                    return false;
+                matchLength += 4;
+                if (matchLength > (size_t)(opEnd - op))
+                    return false;
+                // The match may overlap what it writes (e.g. a run of spaces): copy byte per byte
+                const char *match = op - offset;
+                for (size_t i = 0; i < matchLength; ++i)
+                    op[i] = match[i];
+                op += matchLength;
+            }
+            return op == opEnd;
+        }
+    } // namespace
+
+    std::shared_ptr<const SourceBuffer> TryReadAsset(const std::string &assetPath)
+    {
+        const Pack &pack = GetPack();
+        if (!pack.buffer || assetPath.compare(0, kPackedAssetsPrefix.size(), kPackedAssetsPrefix) != 0)
+            return nullptr;
+        auto it = pack.entryOfPath.find(std::string_view(assetPath).substr(kPackedAssetsPrefix.size()));
+        if (it == pack.entryOfPath.end())
+            return nullptr;
+
+        const Entry &entry = it->second;
+        std::unique_ptr<char[]> bytes(new char[entry.size]);
+        const uint8_t *compressed = (const uint8_t *)pack.buffer->view().data() + entry.offset;
+        if (!Lz4DecompressBlock(compressed, entry.compressedSize, bytes.get(), entry.size))
+        {
+            fprintf(stderr, "AssetPack: %s is corrupt in %s\n", assetPath.c_str(), kPackAssetPath.data());
+            return nullptr;
+        }
+        gNbDecompressions++;
+        return SourceBuffer::FromBytes(std::move(bytes), entry.size);
+    }
+
+    Stats GetStats()
+    {
+        const Pack &pack = GetPack();
+        Stats r;
+        r.hasPack = (pack.buffer != nullptr);
+        if (r.hasPack)
+            r.nbPackedBytes = pack.buffer->view().size();
+        r.nbFiles = (int)pack.entryOfPath.size();
+        for (const auto &kv : pack.entryOfPath)
+            r.nbUnpackedBytes += kv.second.size;
+        r.nbDecompressions = gNbDecompressions;
+        return r;
+    }
+}
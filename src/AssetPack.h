@@ -0,0 +1,26 @@
+#pragma once
+#include "SourceBuffer.h"
+#include <memory>
+#include <string>
+
+// AssetPack reads the code assets from the archive "code.pack", which pack_assets.py builds at build time
+// (when IMGUI_MANUAL_PACK_ASSETS is ON, e.g. for emscripten): it contains the files listed by the libraries
+// of Sources.cpp, each compressed as one LZ4 block. They are decompressed on demand.
+// Without this archive, the code assets are plain files in assets/code.
+// It can be used from any thread.
+namespace AssetPack
+{
+    // assetPath is e.g. "code/imgui/imgui.h".
+    // Returns nullptr if there is no pack, or if it does not contain this asset (e.g. images are not packed)
+    std::shared_ptr<const SourceBuffer> TryReadAsset(const std::string &assetPath);
+
+    struct Stats
+    {
+        bool hasPack = false;
+        int nbFiles = 0;
+        size_t nbPackedBytes = 0;   // size of code.pack
+        size_t nbUnpackedBytes = 0; // total size of its files
+        int nbDecompressions = 0;
+    };
+    Stats GetStats();
+}
@@ -0,0 +1,77 @@
+#include "CodeNavigation.h"
+#include "utilities/IdleThrottle.h"
+#include "imgui_internal.h"
+#include <unordered_map>
+
+namespace CodeNavigation
+{
+    namespace
+    {
+        std::unordered_map<std::string, std::string> gWindowOfSource;
+
+        struct PendingRequest
+        {
+            Request request;
+            std::string windowLabel;
+            bool isPending = false;
+            bool isFocused = false;
+        };
+        PendingRequest gPendingRequest;
+    }
+
+    void RegisterSources(const std::string &windowLabel, const std::vector<std::string> &sourcePaths)
+    {
+        for (const auto &sourcePath : sourcePaths)
+            gWindowOfSource.insert({sourcePath, windowLabel});
+    }
+
+    bool CanShow(const std::string &sourcePath)
+    {
+        return gWindowOfSource.find(sourcePath) != gWindowOfSource.end();
+    }
+
+    void RequestShow(const std::string &sourcePath, int lineNumber)
+    {
+        auto it = gWindowOfSource.find(sourcePath);
+        if (it == gWindowOfSource.end())
+            return;
+        gPendingRequest.request = {sourcePath, lineNumber};
+        gPendingRequest.windowLabel = it->second;
+        gPendingRequest.isPending = true;
+        gPendingRequest.isFocused = false;
+    }
+
+    void ShowRequestedWindow(std::vector<HelloImGui::DockableWindow> &dockableWindows)
+    {
+        // The request takes a few frames (show, focus, then take it)
+        if (gPendingRequest.isPending)
+            IdleThrottle::RequestAnimation();
+        if (!gPendingRequest.isPending || gPendingRequest.isFocused)
+            return;
+        for (auto &dockableWindow : dockableWindows)
+        {
+            if (dockableWindow.label == gPendingRequest.windowLabel)
+            {
+                dockableWindow.isVisible = true;
+                // A window that was hidden is submitted again only from the next frame on
+                ImGuiWindow *window = ImGui::FindWindowByName(dockableWindow.label.c_str());
+                if (window != nullptr && window->WasActive)
+                {
+                    ImGui::SetWindowFocus(dockableWindow.label.c_str());
+                    gPendingRequest.isFocused = true;
+                }
+            }
+        }
+    }
+
+    bool TakeRequestForCurrentWindow(Request *request)
+    {
+        if (!gPendingRequest.isPending)
+            return false;
+        if (gPendingRequest.windowLabel != ImGui::GetCurrentWindow()->Name)
+            return false;
+        *request = gPendingRequest.request;
+        gPendingRequest.isPending = false;
+        return true;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "hello_imgui/hello_imgui.h"
+#include <string>
+#include <vector>
+
+// CodeNavigation lets any window ask to show a given line of a source
+// (e.g. a hit of the global code search):
+// - each source path is registered with the label of the window that can show it
+// - a request makes this window visible and focused (see ShowRequestedWindow)
+// - the window then takes the request (see TakeRequestForCurrentWindow), and moves its editor to the line
+// Requests may wait until their window is built (see LazyWindowRegistry) or its source is loaded.
+namespace CodeNavigation
+{
+    struct Request
+    {
+        std::string sourcePath; // e.g. "imgui/imgui.h"
+        int lineNumber = 0;     // 0 based
+    };
+
+    // If several windows can show the same source, the first registered one wins
+    void RegisterSources(const std::string &windowLabel, const std::vector<std::string> &sourcePaths);
+    // Returns false if no window can show this source
+    bool CanShow(const std::string &sourcePath);
+
+    // A new request replaces the pending one
+    void RequestShow(const std::string &sourcePath, int lineNumber);
+
+    // Call this once per frame: shows and focuses the window of the pending request
+    void ShowRequestedWindow(std::vector<HelloImGui::DockableWindow> &dockableWindows);
+    // Call this from a window gui: returns true (and removes the pending request)
+    // if the pending request is for the current ImGui window
+    bool TakeRequestForCurrentWindow(Request *request);
+}
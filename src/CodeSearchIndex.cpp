@@ -0,0 +1,415 @@
+#include "CodeSearchIndex.h"
+#include "utilities/CacheDir.h"
+#include "utilities/Checksum.h"
+#include "utilities/TextSearch.h"
+#include "utilities/WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+struct CodeSearchIndex::Data
+{
+    struct Posting
+    {
+        uint32_t fileIndex;
+        uint32_t lineNumber;
+        bool operator==(const Posting &other) const
+        {
+            return fileIndex == other.fileIndex && lineNumber == other.lineNumber;
+        }
+        bool operator<(const Posting &other) const
+        {
+            return fileIndex < other.fileIndex || (fileIndex == other.fileIndex && lineNumber < other.lineNumber);
+        }
+    };
+
+    std::vector<Sources::Source> sources;
+    std::vector<std::vector<uint32_t>> lineOffsets; // for each source, the offsets of its lines (+ the end offset)
+
+    std::vector<std::string> tokens;                 // sorted
+    std::vector<uint32_t> postingsStart;             // the postings of tokens[i] are [postingsStart[i], postingsStart[i + 1])
+    std::vector<Posting> postings;
+    TextSearch::LowercaseDocument tokensDocument;    // one token per line, to search for tokens by substring
+
+    CodeSearchIndex::Stats stats;
+};
+
+namespace
+{
+    using Data = CodeSearchIndex::Data;
+    using Posting = Data::Posting;
+
+    constexpr char kCacheMagic[8] = {'I', 'M', 'C', 'S', 'I', 'D', 'X', '1'};
+    constexpr int kMinTokenLength = 2;
+
+    bool isIdentifierChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    bool isIndexable(const std::string &sourcePath)
+    {
+        size_t dot = sourcePath.rfind('.');
+        return dot == std::string::npos || sourcePath.substr(dot) != ".png";
+    }
+
+    Sources::Source readSource(const std::string &sourcePath)
+    {
+        Sources::Source r;
+        r.sourcePath = sourcePath;
+        r.buffer = SourceBuffer::TryFromAsset("code/" + sourcePath);
+        if (r.buffer)
+            r.sourceCode = r.buffer->view();
+        return r;
+    }
+
+    std::vector<uint32_t> computeLineOffsets(std::string_view code)
+    {
+        std::vector<uint32_t> r;
+        r.push_back(0);
+        if (code.empty())
+            return r;
+        const char *data = code.data();
+        const char *end = data + code.size();
+        const char *p = data;
+        while ((p = (const char *)memchr(p, '\n', (size_t)(end - p))) != nullptr)
+        {
+            ++p;
+            r.push_back((uint32_t)(p - data));
+        }
+        if (r.back() != code.size())
+            r.push_back((uint32_t)code.size());
+        return r;
+    }
+
+    void tokenize(const Data &data, std::vector<std::string> *tokens, std::vector<uint32_t> *postingsStart,
+                  std::vector<Posting> *postings)
+    {
+        std::unordered_map<std::string, std::vector<Posting>> postingsOfToken;
+        std::string token;
+        for (uint32_t fileIndex = 0; fileIndex < (uint32_t)data.sources.size(); ++fileIndex)
+        {
+            std::string_view code = data.sources[fileIndex].sourceCode;
+            const auto &lineOffsets = data.lineOffsets[fileIndex];
+            for (uint32_t lineNumber = 0; lineNumber + 1 < (uint32_t)lineOffsets.size(); ++lineNumber)
+            {
+                size_t i = lineOffsets[lineNumber], lineEnd = lineOffsets[lineNumber + 1];
+                while (i < lineEnd)
+                {
+                    if (!isIdentifierChar(code[i]))
+                    {
+                        ++i;
+                        continue;
+                    }
+                    size_t tokenStart = i;
+                    while (i < lineEnd && isIdentifierChar(code[i]))
+                        ++i;
+                    if (i - tokenStart < kMinTokenLength)
+                        continue;
+                    token = TextSearch::ToLower(code.substr(tokenStart, i - tokenStart));
+                    auto &tokenPostings = postingsOfToken[token];
+                    Posting posting{fileIndex, lineNumber};
+                    if (tokenPostings.empty() || !(tokenPostings.back() == posting))
+                        tokenPostings.push_back(posting);
+                }
+            }
+        }
+
+        tokens->clear();
+        tokens->reserve(postingsOfToken.size());
+        for (const auto &kv : postingsOfToken)
+            tokens->push_back(kv.first);
+        std::sort(tokens->begin(), tokens->end());
+        postingsStart->clear();
+        postings->clear();
+        for (const auto &t : *tokens)
+        {
+            postingsStart->push_back((uint32_t)postings->size());
+            const auto &tokenPostings = postingsOfToken[t];
+            postings->insert(postings->end(), tokenPostings.begin(), tokenPostings.end());
+        }
+        postingsStart->push_back((uint32_t)postings->size());
+    }
+
+    //
+    // Cache file: kCacheMagic, then for each source its path, size and cksum, then the tokens
+    // with their postings. It is only used if all the sources are unchanged.
+    //
+    std::string cacheFilePath()
+    {
+        std::string cacheDir = CacheDir::Path();
+        return cacheDir.empty() ? "" : cacheDir + "/code_search_index.bin";
+    }
+
+    void writeU32(FILE *f, uint32_t v) { fwrite(&v, sizeof(v), 1, f); }
+    void writeString(FILE *f, const std::string &s)
+    {
+        writeU32(f, (uint32_t)s.size());
+        fwrite(s.data(), 1, s.size(), f);
+    }
+
+    void saveCache(const Data &data)
+    {
+        std::string path = cacheFilePath();
+        if (path.empty())
+            return;
+        // Write to a temporary file, so that another instance never reads a partial cache
+        std::string tmpPath = path + ".tmp";
+        FILE *f = fopen(tmpPath.c_str(), "wb");
+        if (f == nullptr)
+            return;
+        fwrite(kCacheMagic, 1, sizeof(kCacheMagic), f);
+        writeU32(f, (uint32_t)data.sources.size());
+        for (const auto &source : data.sources)
+        {
+            writeString(f, source.sourcePath);
+            writeU32(f, (uint32_t)source.sourceCode.size());
+            writeU32(f, Checksum::PosixCksum(source.sourceCode.data(), source.sourceCode.size()));
+        }
+        writeU32(f, (uint32_t)data.tokens.size());
+        for (const auto &token : data.tokens)
+            writeString(f, token);
+        fwrite(data.postingsStart.data(), sizeof(uint32_t), data.postingsStart.size(), f);
+        writeU32(f, (uint32_t)data.postings.size());
+        fwrite(data.postings.data(), sizeof(Posting), data.postings.size(), f);
+        bool ok = (ferror(f) == 0);
+        ok = (fclose(f) == 0) && ok;
+        if (ok)
+            ok = (rename(tmpPath.c_str(), path.c_str()) == 0);
+        if (!ok)
+            remove(tmpPath.c_str());
+        else
+            CacheDir::Flush();
+    }
+
+    // Reads the cache bytes, with bounds checks: the cache may be truncated or corrupted
+    class CacheReader
+    {
+    public:
+        explicit CacheReader(std::string_view bytes) : mBytes(bytes) {}
+        bool readU32(uint32_t *v) { return readBytes(v, sizeof(*v)); }
+        bool readString(std::string *s)
+        {
+            uint32_t size;
+            if (!readU32(&size) || size > mBytes.size())
+                return false;
+            s->assign(mBytes.data(), size);
+            mBytes.remove_prefix(size);
+            return true;
+        }
+        bool readBytes(void *dst, size_t size)
+        {
+            if (size > mBytes.size())
+                return false;
+            memcpy(dst, mBytes.data(), size);
+            mBytes.remove_prefix(size);
+            return true;
+        }
+        bool isAtEnd() const { return mBytes.empty(); }
+
+    private:
+        std::string_view mBytes;
+    };
+
+    bool loadCache(Data *data)
+    {
+        std::string path = cacheFilePath();
+        if (path.empty())
+            return false;
+        FILE *f = fopen(path.c_str(), "rb");
+        if (f == nullptr)
+            return false;
+        std::vector<char> bytes;
+        char chunk[65536];
+        size_t nbRead;
+        while ((nbRead = fread(chunk, 1, sizeof(chunk), f)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + nbRead);
+        fclose(f);
+
+        CacheReader reader(std::string_view(bytes.data(), bytes.size()));
+        char magic[sizeof(kCacheMagic)];
+        if (!reader.readBytes(magic, sizeof(magic)) || memcmp(magic, kCacheMagic, sizeof(magic)) != 0)
+            return false;
+        uint32_t nbSources;
+        if (!reader.readU32(&nbSources) || nbSources != data->sources.size())
+            return false;
+        for (const auto &source : data->sources)
+        {
+            std::string sourcePath;
+            uint32_t size, crc;
+            if (!reader.readString(&sourcePath) || !reader.readU32(&size) || !reader.readU32(&crc))
+                return false;
+            if (sourcePath != source.sourcePath || size != source.sourceCode.size())
+                return false;
+            if (crc != Checksum::PosixCksum(source.sourceCode.data(), source.sourceCode.size()))
+                return false;
+        }
+
+        uint32_t nbTokens;
+        if (!reader.readU32(&nbTokens) || nbTokens > bytes.size())
+            return false;
+        data->tokens.resize(nbTokens);
+        for (auto &token : data->tokens)
+            if (!reader.readString(&token))
+                return false;
+        // The tokens are sorted and unique, as tokenize() makes them
+        auto isNotBefore = [](const std::string &a, const std::string &b) { return !(a < b); };
+        if (std::adjacent_find(data->tokens.begin(), data->tokens.end(), isNotBefore) != data->tokens.end())
+            return false;
+        data->postingsStart.resize(nbTokens + 1);
+        if (!reader.readBytes(data->postingsStart.data(), data->postingsStart.size() * sizeof(uint32_t)))
+            return false;
+        uint32_t nbPostings;
+        if (!reader.readU32(&nbPostings) || nbPostings > bytes.size() || data->postingsStart.back() != nbPostings)
+            return false;
+        // Non decreasing, and ending at nbPostings: each token's range of postings lies inside them
+        if (std::adjacent_find(data->postingsStart.begin(), data->postingsStart.end(), std::greater<uint32_t>())
+            != data->postingsStart.end())
+            return false;
+        data->postings.resize(nbPostings);
+        if (!reader.readBytes(data->postings.data(), data->postings.size() * sizeof(Posting)))
+            return false;
+        for (const auto &posting : data->postings)
+            if (posting.fileIndex >= nbSources
+                || posting.lineNumber + 1 >= data->lineOffsets[posting.fileIndex].size())
+                return false;
+        return reader.isAtEnd();
+    }
+
+    std::shared_ptr<Data> buildData(const std::vector<std::string> &sourcePaths)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto data = std::make_shared<Data>();
+        for (const auto &sourcePath : sourcePaths)
+        {
+            data->sources.push_back(readSource(sourcePath));
+            data->lineOffsets.push_back(computeLineOffsets(data->sources.back().sourceCode));
+        }
+
+        data->stats.isLoadedFromCache = loadCache(data.get());
+        if (!data->stats.isLoadedFromCache)
+        {
+            tokenize(*data, &data->tokens, &data->postingsStart, &data->postings);
+            saveCache(*data);
+        }
+        data->tokensDocument = TextSearch::LowercaseDocument(data->tokens);
+
+        data->stats.nbFiles = (int)data->sources.size();
+        data->stats.nbTokens = (int)data->tokens.size();
+        data->stats.nbPostings = data->postings.size();
+        data->stats.buildDurationMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return data;
+    }
+}
+
+
+CodeSearchIndex::CodeSearchIndex(std::vector<std::string> sourcePaths)
+{
+    sourcePaths.erase(std::remove_if(sourcePaths.begin(), sourcePaths.end(),
+                                     [](const std::string &p) { return !isIndexable(p); }),
+                      sourcePaths.end());
+    auto result = std::make_shared<std::shared_ptr<Data>>();
+    std::weak_ptr<bool> aliveToken = mAliveToken;
+    WorkerPool::Submit(
+        [result, sourcePaths] { *result = buildData(sourcePaths); },
+        [this, result, aliveToken] {
+            if (aliveToken.expired())
+                return;
+            mData = *result;
+        });
+}
+
+CodeSearchIndex::~CodeSearchIndex() = default;
+
+std::vector<CodeSearchIndex::Hit> CodeSearchIndex::search(std::string_view query, size_t maxNbHits, bool *isTruncated) const
+{
+    std::vector<Hit> hits;
+    *isTruncated = false;
+    if (!mData)
+        return hits;
+    const Data &data = *mData;
+
+    std::string lowercaseQuery = TextSearch::ToLower(query);
+    if (lowercaseQuery.size() < kMinTokenLength)
+        return hits;
+
+    // The longest identifier of the query gives the candidate lines
+    std::string_view longestIdentifier;
+    for (size_t i = 0; i < lowercaseQuery.size();)
+    {
+        size_t start = i;
+        while (i < lowercaseQuery.size() && isIdentifierChar(lowercaseQuery[i]))
+            ++i;
+        if (i - start > longestIdentifier.size())
+            longestIdentifier = std::string_view(lowercaseQuery).substr(start, i - start);
+        if (i == start)
+            ++i;
+    }
+
+    std::string lowercaseLine;
+    auto checkLine = [&](uint32_t fileIndex, uint32_t lineNumber) {
+        if (hits.size() >= maxNbHits)
+        {
+            *isTruncated = true;
+            return false;
+        }
+        const auto &lineOffsets = data.lineOffsets[fileIndex];
+        std::string_view line = data.sources[fileIndex].sourceCode.substr(
+            lineOffsets[lineNumber], lineOffsets[lineNumber + 1] - lineOffsets[lineNumber]);
+        lowercaseLine = TextSearch::ToLower(line);
+        if (TextSearch::Find(lowercaseLine, lowercaseQuery) != std::string_view::npos)
+            hits.push_back({(int)fileIndex, (int)lineNumber});
+        return true;
+    };
+
+    if (longestIdentifier.size() >= kMinTokenLength)
+    {
+        std::vector<int> tokenIndexes;
+        TextSearch::Filter(std::string(longestIdentifier).c_str())
+            .findMatchingLines(data.tokensDocument, 0, data.tokensDocument.nbLines(), &tokenIndexes);
+        std::vector<Posting> candidates;
+        for (int tokenIndex : tokenIndexes)
+            candidates.insert(candidates.end(),
+                              data.postings.begin() + data.postingsStart[tokenIndex],
+                              data.postings.begin() + data.postingsStart[tokenIndex + 1]);
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (const auto &candidate : candidates)
+            if (!checkLine(candidate.fileIndex, candidate.lineNumber))
+                break;
+    }
+    else
+    {
+        // No usable identifier (e.g. "->"): check all the lines
+        for (uint32_t fileIndex = 0; fileIndex < (uint32_t)data.sources.size(); ++fileIndex)
+            for (uint32_t lineNumber = 0; lineNumber + 1 < (uint32_t)data.lineOffsets[fileIndex].size(); ++lineNumber)
+                if (!checkLine(fileIndex, lineNumber))
+                    return hits;
+    }
+    return hits;
+}
+
+const std::string &CodeSearchIndex::sourcePath(int fileIndex) const
+{
+    return mData->sources[fileIndex].sourcePath;
+}
+
+std::string_view CodeSearchIndex::lineText(const Hit &hit) const
+{
+    const auto &lineOffsets = mData->lineOffsets[hit.fileIndex];
+    std::string_view line = mData->sources[hit.fileIndex].sourceCode.substr(
+        lineOffsets[hit.lineNumber], lineOffsets[hit.lineNumber + 1] - lineOffsets[hit.lineNumber]);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+        line.remove_suffix(1);
+    return line;
+}
+
+CodeSearchIndex::Stats CodeSearchIndex::stats() const
+{
+    return mData ? mData->stats : Stats();
+}
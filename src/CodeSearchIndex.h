@@ -0,0 +1,53 @@
+#pragma once
+#include "Sources.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CodeSearchIndex is a token inverted index over a list of sources
+// (all the libraries shown by the manual, see CodeSearchWindow):
+// - tokens are the lowercased identifiers of the sources ("imgui", "begin", "imvec2", ...)
+// - for each token, the index lists the (file, line) where it appears
+//
+// A query is matched as a case insensitive substring of the lines: the index gives
+// the candidate lines (those that contain a token matching the longest identifier
+// of the query), which are then checked.
+//
+// The index is built in the background (see WorkerPool), and saved into CacheDir,
+// so that later launches only need to check that the sources did not change.
+class CodeSearchIndex
+{
+public:
+    struct Hit
+    {
+        int fileIndex = 0;
+        int lineNumber = 0; // 0 based
+    };
+    struct Stats
+    {
+        int nbFiles = 0;
+        int nbTokens = 0;
+        size_t nbPostings = 0;
+        bool isLoadedFromCache = false;
+        double buildDurationMs = 0.;
+    };
+
+    explicit CodeSearchIndex(std::vector<std::string> sourcePaths);
+    ~CodeSearchIndex();
+
+    bool isReady() const { return (bool)mData; }
+    // Returns the hits in file order, then line order; isTruncated is set if there are more than maxNbHits
+    std::vector<Hit> search(std::string_view query, size_t maxNbHits, bool *isTruncated) const;
+
+    const std::string &sourcePath(int fileIndex) const;
+    std::string_view lineText(const Hit &hit) const;
+    Stats stats() const;
+
+    struct Data;
+private:
+    std::shared_ptr<const Data> mData;
+    // The background build checks this token, since it may finish after this index was freed
+    std::shared_ptr<bool> mAliveToken = std::make_shared<bool>(true);
+};
@@ -0,0 +1,100 @@
+#include "CodeSearchWindow.h"
+#include "CodeNavigation.h"
+#include "Sources.h"
+#include "hello_imgui/hello_imgui.h"
+
+#include <chrono>
+
+namespace
+{
+    constexpr size_t kMaxNbHits = 5000;
+}
+
+std::vector<std::string> CodeSearchWindow::SearchedSourcePaths()
+{
+    std::vector<std::string> r;
+    for (const auto &libraries : {Sources::imguiLibrary(), Sources::otherLibraries(),
+                                  Sources::helloImGuiLibrary(), Sources::imguiManualLibrary()})
+    {
+        auto paths = Sources::librarySourcePaths(libraries);
+        r.insert(r.end(), paths.begin(), paths.end());
+    }
+    return r;
+}
+
+CodeSearchWindow::CodeSearchWindow()
+    : mIndex(SearchedSourcePaths())
+{
+}
+
+void CodeSearchWindow::gui()
+{
+    guiQuery();
+    updateHits();
+    guiHits();
+}
+
+void CodeSearchWindow::guiQuery()
+{
+    ImGui::SetNextItemWidth(300.f);
+    if (ImGui::IsWindowAppearing())
+        ImGui::SetKeyboardFocusHere();
+    ImGui::InputText(ICON_FA_SEARCH " Search all sources", mQuery, sizeof(mQuery));
+    ImGui::SameLine();
+    if (!mIndex.isReady())
+    {
+        ImGui::TextDisabled("Indexing the sources...");
+        return;
+    }
+    auto stats = mIndex.stats();
+    ImGui::TextDisabled("?");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip(
+            "Case insensitive search in all the sources of the libraries\n"
+            "%d files, %d tokens, %zu postings\n"
+            "Index %s in %.1f ms",
+            stats.nbFiles, stats.nbTokens, stats.nbPostings,
+            stats.isLoadedFromCache ? "loaded from the cache" : "built",
+            stats.buildDurationMs);
+}
+
+void CodeSearchWindow::updateHits()
+{
+    if (mHitsQuery == mQuery && mHitsAreFromReadyIndex == mIndex.isReady())
+        return;
+    mHitsQuery = mQuery;
+    mHitsAreFromReadyIndex = mIndex.isReady();
+    auto start = std::chrono::steady_clock::now();
+    mHits = mIndex.search(mHitsQuery, kMaxNbHits, &mHitsAreTruncated);
+    mLastSearchDurationMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CodeSearchWindow::guiHits()
+{
+    if (!mIndex.isReady() || mHitsQuery.size() < 2)
+        return;
+    ImGui::Text("%zu%s hits (%.2f ms)", mHits.size(), mHitsAreTruncated ? "+" : "", mLastSearchDurationMs);
+
+    ImGui::BeginChild("hits");
+    ImGuiListClipper clipper;
+    clipper.Begin((int)mHits.size());
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const auto &hit = mHits[i];
+            const std::string &sourcePath = mIndex.sourcePath(hit.fileIndex);
+            std::string_view lineText = mIndex.lineText(hit);
+            ImGui::PushID(i);
+            if (ImGui::Selectable("##hit", false, ImGuiSelectableFlags_SpanAllColumns))
+                CodeNavigation::RequestShow(sourcePath, hit.lineNumber);
+            ImGui::SameLine();
+            ImGui::TextDisabled("%s:%d", sourcePath.c_str(), hit.lineNumber + 1);
+            ImGui::SameLine();
+            ImGui::TextUnformatted(lineText.data(), lineText.data() + lineText.size());
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndChild();
+}
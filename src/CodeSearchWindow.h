@@ -0,0 +1,30 @@
+#pragma once
+#include "CodeSearchIndex.h"
+#include <string>
+#include <vector>
+
+// This window searches all the sources of the libraries shown by the manual
+// (see CodeSearchIndex); clicking a hit shows it in the window that browses its source
+// (see CodeNavigation)
+class CodeSearchWindow
+{
+public:
+    CodeSearchWindow();
+    void gui();
+
+    // The sources that are searched
+    static std::vector<std::string> SearchedSourcePaths();
+
+private:
+    void guiQuery();
+    void guiHits();
+    void updateHits();
+
+    CodeSearchIndex mIndex;
+    char mQuery[256] = "";
+    std::string mHitsQuery;
+    bool mHitsAreFromReadyIndex = false;
+    std::vector<CodeSearchIndex::Hit> mHits;
+    bool mHitsAreTruncated = false;
+    double mLastSearchDurationMs = 0.;
+};
@@ -0,0 +1,216 @@
+#include "CppTokenizer.h"
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace CppTokenizer
+{
+    namespace
+    {
+        using PaletteIndex = TextEditor::PaletteIndex;
+
+        enum CharClass : unsigned char
+        {
+            Other,
+            Blank,       // ' ', '\t'
+            Hash,        // '#'
+            DoubleQuote,
+            Quote,
+            Letter,      // [a-zA-Z_]
+            Digit,
+            Sign,        // '+', '-': start of a number, or punctuation
+            Dot,         // '.': start of a number, or punctuation
+            Punctuation
+        };
+
+        std::array<CharClass, 256> MakeCharClasses()
+        {
+            std::array<CharClass, 256> classes;
+            classes.fill(Other);
+            classes[(unsigned char)' '] = Blank;
+            classes[(unsigned char)'\t'] = Blank;
+            classes[(unsigned char)'#'] = Hash;
+            classes[(unsigned char)'"'] = DoubleQuote;
+            classes[(unsigned char)'\''] = Quote;
+            for (int c = 'a'; c <= 'z'; ++c)
+                classes[c] = Letter;
+            for (int c = 'A'; c <= 'Z'; ++c)
+                classes[c] = Letter;
+            classes[(unsigned char)'_'] = Letter;
+            for (int c = '0'; c <= '9'; ++c)
+                classes[c] = Digit;
+            classes[(unsigned char)'+'] = Sign;
+            classes[(unsigned char)'-'] = Sign;
+            classes[(unsigned char)'.'] = Dot;
+            // ':' and '#' are not punctuation for CPlusPlus()
+            for (char c : std::string_view("[]{}!%^&*()=~|<>?/;,"))
+                classes[(unsigned char)c] = Punctuation;
+            return classes;
+        }
+
+        const std::array<CharClass, 256> gCharClasses = MakeCharClasses();
+
+        inline CharClass ClassOf(const char *p) { return gCharClasses[(unsigned char)*p]; }
+        inline bool IsDigit(const char *p) { return ClassOf(p) == Digit; }
+        inline bool IsIdentifierChar(const char *p) { return ClassOf(p) == Letter || ClassOf(p) == Digit; }
+
+        // [ \t]*#[ \t]*[a-zA-Z_]+
+        const char *MatchPreprocessor(const char *p, const char *end)
+        {
+            while (p < end && ClassOf(p) == Blank)
+                ++p;
+            if (p == end || *p != '#')
+                return nullptr;
+            ++p;
+            while (p < end && ClassOf(p) == Blank)
+                ++p;
+            if (p == end || ClassOf(p) != Letter)
+                return nullptr;
+            while (p < end && ClassOf(p) == Letter)
+                ++p;
+            return p;
+        }
+
+        // L?\"(\\.|[^\"])*\" where p is after the opening quote.
+        const char *MatchStringEnd(const char *p, const char *end)
+        {
+            // The greedy path of the regex: a backslash escapes the next character
+            for (const char *q = p; q < end; ++q)
+            {
+                if (*q == '"')
+                    return q + 1;
+                if (*q == '\\' && q + 1 < end)
+                    ++q;
+            }
+            // No closing quote on that path: the regex backtracks, and a backslash may then
+            // be matched by [^\"] instead. matchEnd[i] is the end of the first match (in the
+            // regex backtracking order) from position i inside the string, or nullptr.
+            const size_t n = (size_t)(end - p);
+            std::vector<const char *> matchEnd(n + 1, nullptr);
+            for (size_t i = n; i-- > 0;)
+            {
+                if (p[i] == '"')
+                    matchEnd[i] = p + i + 1;
+                else if (p[i] == '\\' && i + 1 < n && matchEnd[i + 2] != nullptr)
+                    matchEnd[i] = matchEnd[i + 2];
+                else
+                    matchEnd[i] = matchEnd[i + 1];
+            }
+            return matchEnd[0];
+        }
+
+        // \'\\?[^\']\'
+        const char *MatchCharacterLiteral(const char *p, const char *end)
+        {
+            if (end - p >= 4 && p[1] == '\\' && p[2] != '\'' && p[3] == '\'')
+                return p + 4;
+            if (end - p >= 3 && p[1] != '\'' && p[2] == '\'')
+                return p + 3;
+            return nullptr;
+        }
+
+        // [+-]?([0-9]+([.][0-9]*)?|[.][0-9]+)([eE][+-]?[0-9]+)?[fF]?
+        // (the other number rules of CPlusPlus() never match first: this one
+        // already matches the start of integers, octals and hexadecimals)
+        const char *MatchNumber(const char *p, const char *end)
+        {
+            if (ClassOf(p) == Sign)
+                ++p;
+            if (p < end && IsDigit(p))
+            {
+                while (p < end && IsDigit(p))
+                    ++p;
+                if (p < end && *p == '.')
+                {
+                    ++p;
+                    while (p < end && IsDigit(p))
+                        ++p;
+                }
+            }
+            else if (p + 1 < end && *p == '.' && IsDigit(p + 1))
+            {
+                ++p;
+                while (p < end && IsDigit(p))
+                    ++p;
+            }
+            else
+                return nullptr;
+
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                const char *q = p + 1;
+                if (q < end && ClassOf(q) == Sign)
+                    ++q;
+                if (q < end && IsDigit(q))
+                {
+                    while (q < end && IsDigit(q))
+                        ++q;
+                    p = q;
+                }
+            }
+            if (p < end && (*p == 'f' || *p == 'F'))
+                ++p;
+            return p;
+        }
+    } // namespace
+
+    bool Tokenize(const char *inBegin, const char *inEnd,
+                  const char *&outBegin, const char *&outEnd, PaletteIndex &paletteIndex)
+    {
+        if (inBegin >= inEnd)
+            return false;
+        const char *end = nullptr;
+        switch (ClassOf(inBegin))
+        {
+        case Blank:
+        case Hash:
+            end = MatchPreprocessor(inBegin, inEnd);
+            paletteIndex = PaletteIndex::Preprocessor;
+            break;
+        case DoubleQuote:
+            end = MatchStringEnd(inBegin + 1, inEnd);
+            paletteIndex = PaletteIndex::String;
+            break;
+        case Quote:
+            end = MatchCharacterLiteral(inBegin, inEnd);
+            paletteIndex = PaletteIndex::CharLiteral;
+            break;
+        case Letter:
+            if (*inBegin == 'L' && inBegin + 1 < inEnd && inBegin[1] == '"')
+            {
+                end = MatchStringEnd(inBegin + 2, inEnd);
+                paletteIndex = PaletteIndex::String;
+            }
+            if (end == nullptr)
+            {
+                end = inBegin + 1;
+                while (end < inEnd && IsIdentifierChar(end))
+                    ++end;
+                paletteIndex = PaletteIndex::Identifier;
+            }
+            break;
+        case Digit:
+        case Sign:
+        case Dot:
+            end = MatchNumber(inBegin, inEnd);
+            paletteIndex = PaletteIndex::Number;
+            if (end == nullptr && ClassOf(inBegin) != Digit)
+            {
+                end = inBegin + 1;
+                paletteIndex = PaletteIndex::Punctuation;
+            }
+            break;
+        case Punctuation:
+            end = inBegin + 1;
+            paletteIndex = PaletteIndex::Punctuation;
+            break;
+        case Other:
+            break;
+        }
+        if (end == nullptr)
+            return false;
+        outBegin = inBegin;
+        outEnd = end;
+        return true;
+    }
+}
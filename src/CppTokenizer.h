@@ -0,0 +1,17 @@
+#pragma once
+#include "TextEditor.h"
+
+// A hand written C++ tokenizer for TextEditor, used instead of the std::regex token rules
+// of TextEditor::LanguageDefinition::CPlusPlus() (see EditorColorizer::LanguageDefinition).
+//
+// It emits the same tokens and palette indices as those rules, which are tried in order
+// at the start of the text (the first rule that matches wins):
+//     preprocessor, string, character literal, number, identifier, punctuation.
+// Characters are dispatched through a 256 entries class table, so that each call
+// only tries the rules that can match its first character.
+namespace CppTokenizer
+{
+    // Has the signature of TextEditor::LanguageDefinition::TokenizeCallback
+    bool Tokenize(const char *inBegin, const char *inEnd,
+                  const char *&outBegin, const char *&outEnd, TextEditor::PaletteIndex &paletteIndex);
+}
@@ -0,0 +1,411 @@
+#include "EditorColorizer.h"
+#include "CppTokenizer.h"
+#include "utilities/WorkerPool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using PaletteIndex = TextEditor::PaletteIndex;
+
+    // TextEditor colorizes this many lines per frame
+    constexpr int kEditorColorizeIncrement = 10000;
+    constexpr int kLinesPerJob = 1000;
+
+    // Bump this when CppTokenizer, TokenizeLine or the payload change.
+    // Payload: varuint nbLines, then for each line: varuint nbCalls, then for each call
+    // u8 (paletteIndex | 0x80 if hasToken), and if hasToken: varuint tokenBegin, varuint (tokenEnd - tokenBegin).
+    // (the inOffset of a call follows from the previous one, as in TokenizeLine)
+    constexpr uint32_t kTokensFormatVersion = 1;
+    constexpr std::string_view kTokensArtifactKind = "colorizer_tokens";
+
+    // The colorizer of the editor being rendered
+    EditorColorizer *gRenderingColorizer = nullptr;
+
+    bool ColorizerTokenize(const char *inBegin, const char *inEnd,
+                           const char *&outBegin, const char *&outEnd, PaletteIndex &paletteIndex)
+    {
+        if (gRenderingColorizer != nullptr)
+            return gRenderingColorizer->tokenize(inBegin, inEnd, outBegin, outEnd, paletteIndex);
+        return CppTokenizer::Tokenize(inBegin, inEnd, outBegin, outEnd, paletteIndex);
+    }
+
+    // Records the calls that TextEditor::ColorizeRange would make on this line:
+    // it moves to the end of each token, or by one character when there is none
+    EditorColorizer::LineTokens TokenizeLine(std::string_view line)
+    {
+        EditorColorizer::LineTokens tokens;
+        const char *begin = line.data();
+        const char *end = begin + line.size();
+        const char *first = begin;
+        while (first < end)
+        {
+            EditorColorizer::TokenizeCall call;
+            call.inOffset = (uint32_t)(first - begin);
+            const char *tokenBegin = nullptr, *tokenEnd = nullptr;
+            call.hasToken = CppTokenizer::Tokenize(first, end, tokenBegin, tokenEnd, call.paletteIndex);
+            if (call.hasToken)
+            {
+                call.tokenBegin = (uint32_t)(tokenBegin - begin);
+                call.tokenEnd = (uint32_t)(tokenEnd - begin);
+            }
+            tokens.push_back(call);
+            if (!call.hasToken)
+                ++first;
+            else if (tokenEnd > first)
+                first = tokenEnd;
+            else
+                break;
+        }
+        return tokens;
+    }
+
+    // (see EditorColorizer::lineText)
+    std::string_view LineText(const std::string &text, const std::vector<size_t> &lineStarts, int lineIndex)
+    {
+        size_t start = lineStarts[lineIndex];
+        size_t end = std::min(lineStarts[lineIndex + 1] - 1, text.size());
+        // TextEditor drops '\r'
+        if (end > start && text[end - 1] == '\r')
+            --end;
+        return {text.data() + start, end - start};
+    }
+
+    // Returns false if the tokens cannot be encoded (e.g. a token that ends before its start)
+    bool EncodeLineTokens(const EditorColorizer::LineTokens &tokens, ArtifactCache::Writer *writer)
+    {
+        writer->writeVarUint((uint32_t)tokens.size());
+        for (const auto &call : tokens)
+        {
+            if (call.hasToken && call.tokenEnd < call.tokenBegin)
+                return false;
+            writer->write((uint8_t)((uint8_t)call.paletteIndex | (call.hasToken ? 0x80 : 0)));
+            if (call.hasToken)
+            {
+                writer->writeVarUint(call.tokenBegin);
+                writer->writeVarUint(call.tokenEnd - call.tokenBegin);
+            }
+        }
+        return true;
+    }
+
+    // The tokens are checked against the line, since they will be replayed on it
+    bool DecodeLineTokens(ArtifactCache::Reader *reader, std::string_view line, EditorColorizer::LineTokens *tokens)
+    {
+        uint32_t nbCalls;
+        if (!reader->readVarUint(&nbCalls) || nbCalls > line.size() + 1)
+            return false;
+        tokens->resize(nbCalls);
+        uint32_t inOffset = 0;
+        for (auto &call : *tokens)
+        {
+            uint8_t flags;
+            if (!reader->read(&flags) || (flags & 0x7F) >= (uint8_t)PaletteIndex::Max || inOffset > line.size())
+                return false;
+            call.inOffset = inOffset;
+            call.paletteIndex = (PaletteIndex)(flags & 0x7F);
+            call.hasToken = (flags & 0x80) != 0;
+            if (!call.hasToken)
+            {
+                ++inOffset;
+                continue;
+            }
+            uint32_t tokenSize;
+            if (!reader->readVarUint(&call.tokenBegin) || !reader->readVarUint(&tokenSize))
+                return false;
+            call.tokenEnd = call.tokenBegin + tokenSize;
+            if (call.tokenBegin > line.size() || tokenSize > line.size() - call.tokenBegin)
+                return false;
+            inOffset = call.tokenEnd;
+        }
+        return true;
+    }
+}
+
+const TextEditor::LanguageDefinition &EditorColorizer::LanguageDefinition()
+{
+    static TextEditor::LanguageDefinition definition = [] {
+        TextEditor::LanguageDefinition r = TextEditor::LanguageDefinition::CPlusPlus();
+        // CppTokenizer replaces the regex token rules
+        r.mTokenRegexStrings.clear();
+        r.mTokenize = ColorizerTokenize;
+        return r;
+    }();
+    return definition;
+}
+
+void EditorColorizer::onTextReplaced(std::string_view text)
+{
+    mAliveToken = std::make_shared<bool>(true);
+    mTokensByLineText.clear();
+    mReplayedTokens = nullptr;
+    mAreJobsSubmitted = false;
+    mHasRendered = false;
+    mGeneration = 0;
+    mPassGeneration = 0;
+    mHasArtifactKey = false;
+    mIsLoadedFromArtifact = false;
+    mState = State::Colorizing;
+    mText = std::make_shared<const std::string>(text);
+    mLineStarts.clear();
+    const char *data = mText->data();
+    size_t start = 0;
+    while (true)
+    {
+        mLineStarts.push_back(start);
+        const void *newLine = memchr(data + start, '\n', mText->size() - start);
+        if (newLine == nullptr)
+            break;
+        start = (size_t)((const char *)newLine - data) + 1;
+    }
+    mLineStarts.push_back(mText->size() + 1);
+    mLineGenerations.assign(mLineStarts.size() - 1, -1);
+    mNbKnownLines = 0;
+}
+
+std::string_view EditorColorizer::lineText(int lineIndex) const
+{
+    return LineText(*mText, mLineStarts, lineIndex);
+}
+
+void EditorColorizer::setLineTokens(int lineIndex, LineTokens &&tokens)
+{
+    if (mLineGenerations[lineIndex] >= 0)
+        return;
+    mLineGenerations[lineIndex] = mGeneration;
+    ++mNbKnownLines;
+    // TextEditor does not tokenize empty lines; identical lines share their tokens
+    std::string_view text = lineText(lineIndex);
+    if (!text.empty())
+        mTokensByLineText.emplace(text, std::move(tokens));
+}
+
+bool EditorColorizer::tokenizeLinesNow(int firstLine, int endLine)
+{
+    firstLine = std::max(firstLine, 0);
+    endLine = std::min(endLine, (int)mLineGenerations.size());
+    bool hadUnknownLines = false;
+    for (int i = firstLine; i < endLine; ++i)
+    {
+        if (mLineGenerations[i] >= 0)
+        {
+            hadUnknownLines |= (mLineGenerations[i] > mPassGeneration);
+            continue;
+        }
+        setLineTokens(i, TokenizeLine(lineText(i)));
+        hadUnknownLines = true;
+    }
+    return hadUnknownLines;
+}
+
+void EditorColorizer::loadArtifact()
+{
+    struct LoadedTokens
+    {
+        ArtifactCache::Key key;
+        std::vector<LineTokens> lineTokens; // empty if the cache has no valid tokens for the text
+    };
+    auto loaded = std::make_shared<LoadedTokens>();
+    std::weak_ptr<bool> aliveToken = mAliveToken;
+    WorkerPool::Submit(
+        [loaded, text = mText, lineStarts = mLineStarts] {
+            loaded->key = ArtifactCache::MakeKey(kTokensArtifactKind, kTokensFormatVersion, *text);
+            std::string payload;
+            if (!ArtifactCache::Load(loaded->key, &payload))
+                return;
+            ArtifactCache::Reader reader(payload);
+            uint32_t nbLines;
+            if (!reader.readVarUint(&nbLines) || nbLines + 1 != lineStarts.size())
+                return;
+            std::vector<LineTokens> lineTokens(nbLines);
+            for (uint32_t i = 0; i < nbLines; ++i)
+                if (!DecodeLineTokens(&reader, LineText(*text, lineStarts, (int)i), &lineTokens[i]))
+                    return;
+            if (reader.isAtEnd())
+                loaded->lineTokens = std::move(lineTokens);
+        },
+        [this, loaded, aliveToken] {
+            if (aliveToken.expired())
+                return;
+            mArtifactKey = std::move(loaded->key);
+            mHasArtifactKey = true;
+            if (loaded->lineTokens.empty())
+            {
+                submitBackgroundJobs(mFirstVisibleLine);
+                return;
+            }
+            mIsLoadedFromArtifact = true;
+            ++mGeneration;
+            for (size_t i = 0; i < loaded->lineTokens.size(); ++i)
+                setLineTokens((int)i, std::move(loaded->lineTokens[i]));
+        });
+    mAreJobsSubmitted = true;
+}
+
+void EditorColorizer::submitBackgroundJobs(int firstVisibleLine)
+{
+    // Jobs are submitted in order of distance to the viewport, which is what matters
+    // when they run under a frame budget (emscripten)
+    const int nbLines = (int)mLineGenerations.size();
+    const int nbJobs = (nbLines + kLinesPerJob - 1) / kLinesPerJob;
+    const int visibleJob = std::min(std::max(firstVisibleLine, 0) / kLinesPerJob, std::max(nbJobs - 1, 0));
+    std::vector<int> jobOrder;
+    for (int distance = 0; (int)jobOrder.size() < nbJobs; ++distance)
+    {
+        if (visibleJob + distance < nbJobs)
+            jobOrder.push_back(visibleJob + distance);
+        if (distance > 0 && visibleJob - distance >= 0)
+            jobOrder.push_back(visibleJob - distance);
+    }
+
+    std::weak_ptr<bool> aliveToken = mAliveToken;
+    for (int job : jobOrder)
+    {
+        const int firstLine = job * kLinesPerJob;
+        const int endLine = std::min(firstLine + kLinesPerJob, nbLines);
+        std::vector<std::string_view> lines;
+        lines.reserve(endLine - firstLine);
+        for (int i = firstLine; i < endLine; ++i)
+            lines.push_back(lineText(i));
+        auto result = std::make_shared<std::vector<LineTokens>>();
+        WorkerPool::Submit(
+            [result, lines, text = mText] {
+                result->reserve(lines.size());
+                for (std::string_view line : lines)
+                    result->push_back(TokenizeLine(line));
+            },
+            [this, result, firstLine, aliveToken] {
+                if (aliveToken.expired())
+                    return;
+                ++mGeneration;
+                for (size_t i = 0; i < result->size(); ++i)
+                    setLineTokens(firstLine + (int)i, std::move((*result)[i]));
+            });
+    }
+}
+
+void EditorColorizer::storeArtifact()
+{
+    // Tokens read from the cache are there already; without a key, the load is still pending
+    if (mIsLoadedFromArtifact || !mHasArtifactKey)
+        return;
+    struct TokensToStore
+    {
+        ArtifactCache::Key key;
+        std::shared_ptr<const std::string> text;
+        std::vector<size_t> lineStarts;
+        std::unordered_map<std::string_view, LineTokens> tokensByLineText; // keys point into text
+    };
+    auto tokens = std::make_shared<TokensToStore>();
+    tokens->key = mArtifactKey;
+    tokens->text = mText;
+    tokens->lineStarts = std::move(mLineStarts);
+    tokens->tokensByLineText = std::move(mTokensByLineText);
+    WorkerPool::Submit([tokens] {
+        const int nbLines = (int)tokens->lineStarts.size() - 1;
+        const LineTokens noTokens;
+        ArtifactCache::Writer writer;
+        writer.writeVarUint((uint32_t)nbLines);
+        for (int i = 0; i < nbLines; ++i)
+        {
+            std::string_view line = LineText(*tokens->text, tokens->lineStarts, i);
+            auto it = tokens->tokensByLineText.find(line);
+            if (it == tokens->tokensByLineText.end() && !line.empty())
+                return;
+            if (!EncodeLineTokens(line.empty() ? noTokens : it->second, &writer))
+                return;
+        }
+        ArtifactCache::Store(tokens->key, writer.bytes());
+    });
+}
+
+void EditorColorizer::beginRender(TextEditor &editor, int firstVisibleLine, int nbVisibleLines)
+{
+    gRenderingColorizer = this;
+    if (mState != State::Colorizing)
+        return;
+
+    ++mGeneration;
+    mFirstVisibleLine = firstVisibleLine;
+    int cursorLine = editor.GetCursorPosition().mLine;
+    bool hadUnknownLines = tokenizeLinesNow(firstVisibleLine, firstVisibleLine + nbVisibleLines);
+    hadUnknownLines |= tokenizeLinesNow(cursorLine - nbVisibleLines, cursorLine + nbVisibleLines);
+    if (!mAreJobsSubmitted)
+        loadArtifact();
+
+    bool isAllKnown = (mNbKnownLines == (int)mLineGenerations.size());
+    if (isAllKnown)
+    {
+        mState = State::Replaying;
+        mNbReplayRendersLeft = (int)mLineGenerations.size() / kEditorColorizeIncrement + 1;
+    }
+    // The first render colorizes the lines known so far: the others are colorized again
+    // once they are visible and known, or when all the lines are known
+    if (!mHasRendered)
+        mPassGeneration = mGeneration;
+    else if (hadUnknownLines || isAllKnown)
+    {
+        // (this is the only public way to make TextEditor colorize its whole text)
+        editor.SetLanguageDefinition(LanguageDefinition());
+        mPassGeneration = mGeneration;
+    }
+}
+
+void EditorColorizer::endRender()
+{
+    gRenderingColorizer = nullptr;
+    mReplayedTokens = nullptr;
+    mHasRendered = true;
+    if (mState == State::Replaying && --mNbReplayRendersLeft <= 0)
+    {
+        mState = State::Complete;
+        storeArtifact();
+        // The jobs that are still pending (e.g. when the lines were all tokenized by tokenizeLinesNow) are dropped
+        mAliveToken = std::make_shared<bool>(true);
+        mTokensByLineText = {};
+        mLineStarts = {};
+        mLineGenerations = {};
+        mText.reset();
+    }
+}
+
+bool EditorColorizer::tokenize(const char *inBegin, const char *inEnd,
+                               const char *&outBegin, const char *&outEnd, PaletteIndex &paletteIndex)
+{
+    if (mState == State::Complete)
+        return CppTokenizer::Tokenize(inBegin, inEnd, outBegin, outEnd, paletteIndex);
+
+    // TextEditor calls the tokenizer on a whole line first, then on what follows each token
+    bool continuesReplayedLine = mReplayedTokens != nullptr
+        && inEnd == mReplayedLineEnd
+        && mReplayIndex < mReplayedTokens->size()
+        && inBegin == mReplayedLineBegin + (*mReplayedTokens)[mReplayIndex].inOffset;
+    if (!continuesReplayedLine)
+    {
+        mReplayedTokens = nullptr;
+        auto it = mTokensByLineText.find(std::string_view(inBegin, (size_t)(inEnd - inBegin)));
+        if (it == mTokensByLineText.end() || it->second.empty())
+        {
+            if (mState == State::Replaying)
+                // An edited line
+                return CppTokenizer::Tokenize(inBegin, inEnd, outBegin, outEnd, paletteIndex);
+            // Left uncolored for now
+            outBegin = inBegin;
+            outEnd = inEnd;
+            paletteIndex = PaletteIndex::Default;
+            return true;
+        }
+        mReplayedTokens = &it->second;
+        mReplayedLineBegin = inBegin;
+        mReplayedLineEnd = inEnd;
+        mReplayIndex = 0;
+    }
+
+    const TokenizeCall &call = (*mReplayedTokens)[mReplayIndex++];
+    if (!call.hasToken)
+        return false;
+    outBegin = mReplayedLineBegin + call.tokenBegin;
+    outEnd = mReplayedLineBegin + call.tokenEnd;
+    paletteIndex = call.paletteIndex;
+    return true;
+}
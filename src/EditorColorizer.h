@@ -0,0 +1,102 @@
+#pragma once
+#include "TextEditor.h"
+#include "utilities/ArtifactCache.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// EditorColorizer lets an editor paint a large source before it is fully colorized.
+//
+// After SetText, TextEditor colorizes the whole text from the top (10000 lines per frame),
+// by calling the tokenizer of its language definition on each line. The editors use
+// EditorColorizer::LanguageDefinition(), whose tokenizer asks the colorizer of the editor
+// being rendered (see beginRender):
+// - the colorizer computes the tokens of the lines: the visible ones right before the render,
+//   and the others in the background (see WorkerPool), starting near the viewport
+// - lines whose tokens are known are replayed, the others are left uncolored (which is cheap),
+//   and the editor is asked to colorize again once they are known
+// - when all the lines were colorized, the tokens are freed: the colors stay in the editor,
+//   and edited lines are tokenized as usual
+// - the tokens are also saved into the ArtifactCache: when the same text is colorized again
+//   (e.g. at the next launch), they are read back instead of being computed
+class EditorColorizer
+{
+public:
+    EditorColorizer() = default;
+    EditorColorizer(const EditorColorizer &) = delete;
+    EditorColorizer &operator=(const EditorColorizer &) = delete;
+
+    // C++, tokenized by CppTokenizer through the colorizers
+    static const TextEditor::LanguageDefinition &LanguageDefinition();
+
+    // Call this after TextEditor::SetText
+    void onTextReplaced(std::string_view text);
+    // Call these around TextEditor::Render. The visible lines, and those around the
+    // cursor (which Render may scroll to), are tokenized first.
+    void beginRender(TextEditor &editor, int firstVisibleLine, int nbVisibleLines);
+    void endRender();
+
+    bool isComplete() const { return mState == State::Complete; }
+
+    // Called by the tokenizer of LanguageDefinition()
+    bool tokenize(const char *inBegin, const char *inEnd,
+                  const char *&outBegin, const char *&outEnd, TextEditor::PaletteIndex &paletteIndex);
+
+    // A call to the C++ tokenizer, with offsets relative to the start of its line
+    struct TokenizeCall
+    {
+        uint32_t inOffset = 0;
+        uint32_t tokenBegin = 0, tokenEnd = 0;
+        TextEditor::PaletteIndex paletteIndex = TextEditor::PaletteIndex::Default;
+        bool hasToken = false;
+    };
+    using LineTokens = std::vector<TokenizeCall>;
+
+private:
+    enum class State
+    {
+        Colorizing, // lines are being tokenized; unknown lines are left uncolored
+        Replaying,  // all lines are known, and the editor colorizes them again
+        Complete    // the editor is colorized; its tokenizer is used directly
+    };
+
+    std::string_view lineText(int lineIndex) const;
+    void setLineTokens(int lineIndex, LineTokens &&tokens);
+    // Returns true if some of the lines were unknown
+    bool tokenizeLinesNow(int firstLine, int endLine);
+    // Reads the tokens from the ArtifactCache, or else calls submitBackgroundJobs
+    void loadArtifact();
+    void submitBackgroundJobs(int firstVisibleLine);
+    // Moves the tokens to a background job that saves them into the ArtifactCache
+    void storeArtifact();
+
+    State mState = State::Complete;
+    std::shared_ptr<const std::string> mText;
+    std::vector<size_t> mLineStarts;    // nbLines + 1 entries: the last one is past the end
+    std::vector<int> mLineGenerations;  // when the tokens of a line were known, or -1
+    int mNbKnownLines = 0;
+    std::unordered_map<std::string_view, LineTokens> mTokensByLineText; // keys point into mText
+    int mGeneration = 0;
+    int mPassGeneration = 0;            // the generation when the editor was last asked to colorize
+    bool mAreJobsSubmitted = false;
+    bool mHasRendered = false;
+    int mNbReplayRendersLeft = 0;
+    int mFirstVisibleLine = 0;
+
+    ArtifactCache::Key mArtifactKey{};
+    bool mHasArtifactKey = false;       // computed by loadArtifact()
+    bool mIsLoadedFromArtifact = false;
+
+    // The line being replayed by tokenize()
+    const LineTokens *mReplayedTokens = nullptr;
+    const char *mReplayedLineBegin = nullptr;
+    const char *mReplayedLineEnd = nullptr;
+    size_t mReplayIndex = 0;
+
+    // Background jobs check this token, since they may finish after this colorizer was freed,
+    // or after its text was replaced
+    std::shared_ptr<bool> mAliveToken = std::make_shared<bool>(true);
+};
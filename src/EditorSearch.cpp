@@ -0,0 +1,122 @@
+#include "EditorSearch.h"
+#include <algorithm>
+
+void EditorSearch::update(const TextEditor &editor, const ImGuiTextFilter &filter)
+{
+    // TextEditor gives no access to individual lines: this copy is made only when
+    // the filter or the text changed
+    update([&editor] { return TextSearch::LowercaseDocument(editor.GetTextLines()); },
+           [&editor] { return editor.GetTotalLines(); }, filter);
+}
+
+void EditorSearch::update(std::string_view text, const ImGuiTextFilter &filter)
+{
+    update([text] { return TextSearch::LowercaseDocument(text); },
+           [text] { return (int)std::count(text.begin(), text.end(), '\n') + 1; }, filter);
+}
+
+void EditorSearch::update(const std::function<TextSearch::LowercaseDocument()> &makeDocument,
+                          const std::function<int()> &countLines, const ImGuiTextFilter &filter)
+{
+    bool filterChanged = (mFilterText != filter.InputBuf);
+    if (mIsValid && !filterChanged && !mMaybeEdited)
+        return;
+
+    if (filterChanged)
+    {
+        mFilterText = filter.InputBuf;
+        mTextFilter = TextSearch::Filter(filter.InputBuf);
+    }
+    if (!filter.IsActive())
+    {
+        // The text is not read: it will be when a filter is entered
+        mMatchesAllLines = true;
+        mNbLines = countLines();
+        mMatchingLines.clear();
+        mDocument = TextSearch::LowercaseDocument();
+    }
+    else
+    {
+        TextSearch::LowercaseDocument document = makeDocument();
+        if (!mIsValid || filterChanged || mMatchesAllLines)
+        {
+            mMatchesAllLines = false;
+            mMatchingLines.clear();
+            mTextFilter.findMatchingLines(document, 0, document.nbLines(), &mMatchingLines);
+            mDocument = std::move(document);
+        }
+        else
+            updateByPrefixSuffixDiff(std::move(document));
+    }
+
+    mIsValid = true;
+    mMaybeEdited = false;
+}
+
+void EditorSearch::updateByPrefixSuffixDiff(TextSearch::LowercaseDocument &&document)
+{
+    const int oldNbLines = mDocument.nbLines();
+    const int newNbLines = document.nbLines();
+
+    // The edited lines are between the common prefix and the common suffix
+    // of the old and new texts (the comparison is done on the lowercased text,
+    // since a change of case does not change the matches)
+    int nbSameFirst = 0;
+    while (nbSameFirst < oldNbLines && nbSameFirst < newNbLines
+           && mDocument.line(nbSameFirst) == document.line(nbSameFirst))
+        ++nbSameFirst;
+    int nbSameLast = 0;
+    while (nbSameLast < oldNbLines - nbSameFirst && nbSameLast < newNbLines - nbSameFirst
+           && mDocument.line(oldNbLines - 1 - nbSameLast) == document.line(newNbLines - 1 - nbSameLast))
+        ++nbSameLast;
+
+    const int oldEditEnd = oldNbLines - nbSameLast; // the edit replaced old lines [nbSameFirst, oldEditEnd)
+    const int newEditEnd = newNbLines - nbSameLast; // by new lines [nbSameFirst, newEditEnd)
+    const int delta = newNbLines - oldNbLines;
+
+    std::vector<int> matchingLines;
+    for (int line : mMatchingLines)
+    {
+        if (line >= nbSameFirst)
+            break;
+        matchingLines.push_back(line);
+    }
+    mTextFilter.findMatchingLines(document, nbSameFirst, newEditEnd, &matchingLines);
+    for (int line : mMatchingLines)
+        if (line >= oldEditEnd)
+            matchingLines.push_back(line + delta);
+
+    mMatchingLines = std::move(matchingLines);
+    mDocument = std::move(document);
+}
+
+int EditorSearch::nbMatches() const
+{
+    return mMatchesAllLines ? mNbLines : (int)mMatchingLines.size();
+}
+
+int EditorSearch::rankOf(int line) const
+{
+    if (mMatchesAllLines)
+        return (line >= 0 && line < mNbLines) ? line : -1;
+    auto it = std::lower_bound(mMatchingLines.begin(), mMatchingLines.end(), line);
+    if (it == mMatchingLines.end() || *it != line)
+        return -1;
+    return (int)(it - mMatchingLines.begin());
+}
+
+int EditorSearch::nextMatch(int line) const
+{
+    if (mMatchesAllLines)
+        return (line + 1 < mNbLines) ? std::max(line + 1, 0) : -1;
+    auto it = std::upper_bound(mMatchingLines.begin(), mMatchingLines.end(), line);
+    return (it == mMatchingLines.end()) ? -1 : *it;
+}
+
+int EditorSearch::previousMatch(int line) const
+{
+    if (mMatchesAllLines)
+        return (line > 0 && mNbLines > 0) ? std::min(line - 1, mNbLines - 1) : -1;
+    auto it = std::lower_bound(mMatchingLines.begin(), mMatchingLines.end(), line);
+    return (it == mMatchingLines.begin()) ? -1 : *(it - 1);
+}
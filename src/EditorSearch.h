@@ -0,0 +1,52 @@
+#pragma once
+#include "TextEditor.h"
+#include "imgui.h"
+#include "utilities/TextSearch.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// EditorSearch caches the sorted list of the lines of an editor that match a filter
+// (see WindowWithEditor::guiFind).
+// The cache is recomputed when the filter changes. After an edit, the text is still copied
+// and lowercased as a whole (TextEditor tells neither which lines changed, nor gives access to
+// a single line): it is then diffed with the previous text, and only the lines between their
+// common prefix and suffix are matched again.
+// Lines are matched with the TextSearch kernel, which gives the same results as ImGuiTextFilter:
+// an empty filter matches every line (e.g. the arrows then go to the next / previous line).
+class EditorSearch
+{
+public:
+    // Call this when the whole text was replaced (e.g. TextEditor::SetText)
+    void onTextReplaced() { mIsValid = false; }
+    // Call this when the text may have been edited
+    void onTextEdited() { mMaybeEdited = true; }
+
+    // Updates the cache if the filter or the text changed
+    void update(const TextEditor &editor, const ImGuiTextFilter &filter);
+    // Same, for a read-only text (see LargeFileView), whose lines are separated by '\n'
+    void update(std::string_view text, const ImGuiTextFilter &filter);
+
+    int nbMatches() const;
+    // Rank (0 based) of line among the matching lines, or -1 if it does not match
+    int rankOf(int line) const;
+    // Next / previous matching line, or -1 if there is none
+    int nextMatch(int line) const;
+    int previousMatch(int line) const;
+
+private:
+    void update(const std::function<TextSearch::LowercaseDocument()> &makeDocument,
+                const std::function<int()> &countLines, const ImGuiTextFilter &filter);
+    // Matches again the lines between the common prefix and suffix of mDocument and document
+    void updateByPrefixSuffixDiff(TextSearch::LowercaseDocument &&document);
+
+    std::string mFilterText;          // the filter for which mMatchingLines was computed
+    TextSearch::Filter mTextFilter;
+    std::vector<int> mMatchingLines;  // sorted; empty if mMatchesAllLines
+    bool mMatchesAllLines = false;    // the filter is empty: the lines are counted, not listed
+    int mNbLines = 0;                 // only if mMatchesAllLines
+    TextSearch::LowercaseDocument mDocument; // the text for which mMatchingLines was computed
+    bool mIsValid = false;
+    bool mMaybeEdited = false;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include "EditorColorizer.h"
+#include "TextEditor.h"
+#include <memory>
+
+// The state of an editor that displays a source: its tokenized and colorized lines,
+// its cursor and breakpoints (all inside the TextEditor), and its scroll position.
+// Saving and restoring a snapshot only moves a pointer: it costs the same for any source size.
+struct EditorSnapshot
+{
+    std::shared_ptr<TextEditor> editor;
+    std::shared_ptr<EditorColorizer> colorizer; // may still be colorizing the editor
+    float scrollY = 0.f;
+};
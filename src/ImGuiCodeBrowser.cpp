@@ -6,7 +6,7 @@
 
 
 ImGuiCodeBrowser::ImGuiCodeBrowser()
-    : mLibrariesCodeBrowser(Sources::imguiLibrary(), "imgui/imgui.h")
+    : mLibrariesCodeBrowser("ImGuiCodeBrowser", Sources::imguiLibrary(), "imgui/imgui.h")
 {
 }
 
@@ -22,7 +22,7 @@ void ImGuiCodeBrowser::guiHelp()
     if (showHelp)
     {
         // Readme
-        std::string help = R"(
+        const char *help = R"(
 This is the core of ImGui code.
 
 Usage (extract from [ImGui Readme](https://github.com/ocornut/imgui#usage))
@@ -35,7 +35,7 @@ You will need a backend to integrate Dear ImGui in your app. The backend passes
 
 Backends for a variety of graphics api and rendering platforms are provided in the [examples/](https://github.com/ocornut/imgui/tree/master/examples) folder, along with example applications. See the [Integration](https://github.com/ocornut/imgui#integration) section of this document for details. You may also create your own backend. Anywhere where you can render textured triangles, you can render Dear ImGui.
 )";
-        MarkdownHelper::Markdown(help.c_str());
+        MarkdownHelper::Markdown(help);
         if (ImGui::Button(ICON_FA_THUMBS_UP " Got it"))
         showHelp = false;
     }
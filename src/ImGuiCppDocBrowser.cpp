@@ -1,39 +1,96 @@
 #include "ImGuiRepoUrl.h"
 
-#include "utilities/ImGuiExt.h"
 #include "utilities/HyperlinkHelper.h"
 
-#include <fplus/fplus.hpp>
-
 #include "ImGuiCppDocBrowser.h"
+#include <algorithm>
 
 ImGuiCppDocBrowser::ImGuiCppDocBrowser()
-    : WindowWithEditor()
-    , mAnnotatedSource(Sources::ReadImGuiCppDoc("imgui/imgui.cpp"))
+    : WindowWithEditor("ImGuiCppDocBrowser")
 {
-    setEditorAnnotatedSource(mAnnotatedSource);
+    setEditorAnnotatedSourceAsync(
+        [] { return Sources::ReadImGuiCppDoc("imgui/imgui.cpp"); },
+        [this](Sources::AnnotatedSource &annotatedSource) {
+            mAnnotatedSource = std::move(annotatedSource);
+            mIsSectionOpen.assign(mAnnotatedSource.linesWithTags.size(), false);
+            updateOutlineRows();
+        });
 }
 
 void ImGuiCppDocBrowser::gui()
 {
     ImGui::Text("The doc for Dear ImGui is simply stored inside imgui.cpp");
-    guiTags();
+    guiOutline();
     RenderEditor("imgui.cpp", [this] { this->guiGithubButton(); });
 }
 
-void ImGuiCppDocBrowser::guiTags()
+bool ImGuiCppDocBrowser::hasSubsections(size_t tagIndex) const
+{
+    const auto &linesWithTags = mAnnotatedSource.linesWithTags;
+    return tagIndex + 1 < linesWithTags.size() && linesWithTags[tagIndex + 1].level == Sources::TagLevel::H2;
+}
+
+void ImGuiCppDocBrowser::updateOutlineRows()
+{
+    mOutlineRows.clear();
+    bool isInOpenSection = true; // H2 titles before the first H1 are always shown
+    const auto &linesWithTags = mAnnotatedSource.linesWithTags;
+    for (size_t i = 0; i < linesWithTags.size(); ++i)
+    {
+        if (linesWithTags[i].level == Sources::TagLevel::H1)
+        {
+            isInOpenSection = mIsSectionOpen[i];
+            mOutlineRows.push_back(i);
+        }
+        else if (isInOpenSection)
+            mOutlineRows.push_back(i);
+    }
+}
+
+void ImGuiCppDocBrowser::guiOutline()
 {
-    for (auto lineWithTag : mAnnotatedSource.linesWithTags)
+    if (mOutlineRows.empty())
+        return;
+    // Only the visible rows are drawn
+    const int maxNbVisibleRows = 12;
+    int nbVisibleRows = std::min((int)mOutlineRows.size(), maxNbVisibleRows);
+    ImVec2 outlineSize(0.f, ImGui::GetTextLineHeightWithSpacing() * (float)nbVisibleRows + ImGui::GetStyle().WindowPadding.y * 2.f);
+    ImGui::BeginChild("Outline", outlineSize, true);
+    bool wasToggled = false;
+    ImGuiListClipper clipper;
+    clipper.Begin((int)mOutlineRows.size());
+    while (clipper.Step())
     {
-        // tags are of type H1 or H2, and begin with "H1 " or "H2 " (3 characters)
-        std::string title = fplus::drop(3, lineWithTag.tag);
-        bool isHeader1 = (fplus::take(3, lineWithTag.tag) == "H1 ");
-        if (isHeader1)
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
         {
-            if (ImGuiExt::ClickableText(title.c_str()))
-                mEditor.SetCursorPosition({lineWithTag.lineNumber, 0}, 3);
+            size_t tagIndex = mOutlineRows[(size_t)row];
+            const auto &lineWithTag = mAnnotatedSource.linesWithTags[tagIndex];
+            bool isHeader2 = (lineWithTag.level == Sources::TagLevel::H2);
+            ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_OpenOnArrow
+                                       | ImGuiTreeNodeFlags_SpanAvailWidth;
+            if (isHeader2 || !hasSubsections(tagIndex))
+                flags |= ImGuiTreeNodeFlags_Leaf;
+            else
+                ImGui::SetNextItemOpen(mIsSectionOpen[tagIndex], ImGuiCond_Always);
+
+            if (isHeader2)
+                ImGui::Indent();
+            ImGui::TreeNodeEx(lineWithTag.label.c_str(), flags);
+            if (ImGui::IsItemToggledOpen())
+            {
+                mIsSectionOpen[tagIndex] = !mIsSectionOpen[tagIndex];
+                wasToggled = true;
+            }
+            else if (ImGui::IsItemClicked())
+                setCursorLine(lineWithTag.lineNumber, 3);
+            if (isHeader2)
+                ImGui::Unindent();
         }
     }
+    ImGui::EndChild();
+    // The rows are not changed while the clipper iterates on them
+    if (wasToggled)
+        updateOutlineRows();
 }
 
 void ImGuiCppDocBrowser::guiGithubButton()
@@ -41,7 +98,7 @@ void ImGuiCppDocBrowser::guiGithubButton()
     if (ImGui::SmallButton("View on github at this line"))
     {
         std::string url = ImGuiRepoUrl() + "imgui.cpp#L"
-                          + std::to_string(mEditor.GetCursorPosition().mLine);
+                          + std::to_string(cursorLine());
         HyperlinkHelper::OpenUrl(url);
     }
 }
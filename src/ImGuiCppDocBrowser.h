@@ -10,8 +10,13 @@ public:
     void gui();
 
 private:
-    void guiTags();
+    void guiOutline();
     void guiGithubButton();
+    void updateOutlineRows();
+    bool hasSubsections(size_t tagIndex) const;
 
     Sources::AnnotatedSource mAnnotatedSource;
+    // The outline shows the H1 titles, and the H2 titles of the open sections
+    std::vector<bool> mIsSectionOpen; // per entry of mAnnotatedSource.linesWithTags
+    std::vector<size_t> mOutlineRows; // the entries that are shown
 };
@@ -1,38 +1,57 @@
 #include "ImGuiRepoUrl.h"
 
+#include "utilities/FuzzyMatch.h"
 #include "utilities/HyperlinkHelper.h"
-#include "utilities/ImGuiExt.h"
 #include "utilities/MarkdownHelper.h"
+#include "utilities/Profiler.h"
 
 #include "hello_imgui/hello_imgui.h"
 
 #include "ImGuiDemoBrowser.h"
 
+#include <algorithm>
+
 
 // implImGuiDemoCallbackDemoCallback is the implementation
 // of imgui_demo.cpp's global callback (gImGuiDemoCallback)
-// And  gEditorImGuiDemo is a global reference to the text editor
-// used by this callback
-TextEditor *gEditorImGuiDemo = nullptr;
+// And  gImGuiDemoBrowser is a global reference to the window
+// used by this callback (its editor may be replaced, see SourceCache)
+ImGuiDemoBrowser *gImGuiDemoBrowser = nullptr;
 void implImGuiDemoCallbackDemoCallback(int line_number)
 {
+    // The demo code window may not be built yet (see LazyWindowRegistry)
+    if (gImGuiDemoBrowser == nullptr)
+        return;
     int cursorLineOnPage = 3;
-    gEditorImGuiDemo->SetCursorPosition({line_number, 0}, cursorLineOnPage);
+    gImGuiDemoBrowser->setCursorLine(line_number, cursorLineOnPage);
 }
 
 
 ImGuiDemoBrowser::ImGuiDemoBrowser()
-    : WindowWithEditor()
-    , mAnnotatedSource(Sources::ReadImGuiDemoCode("imgui/imgui_demo.cpp"))
+    : WindowWithEditor("ImGuiDemoBrowser")
 {
-    setEditorAnnotatedSource(mAnnotatedSource);
+    setEditorAnnotatedSourceAsync(
+        [] { return Sources::ReadImGuiDemoCode("imgui/imgui_demo.cpp"); },
+        [this](Sources::AnnotatedSource &annotatedSource) {
+            mAnnotatedSource = std::move(annotatedSource);
+            std::vector<std::string> tags;
+            for (const auto &lineWithTag : mAnnotatedSource.linesWithTags)
+                tags.push_back(lineWithTag.tag);
+            mTagsDocument = TextSearch::LowercaseDocument(tags);
+            mMatchingTagsAreValid = false;
+        });
 
     // Setup of imgui_demo.cpp's global callback
     // (gImGuiDemoCallback belongs to imgui.cpp!)
-    gEditorImGuiDemo = _GetTextEditorPtr();
+    gImGuiDemoBrowser = this;
     gImGuiDemoCallback = implImGuiDemoCallbackDemoCallback;
 }
 
+ImGuiDemoBrowser::~ImGuiDemoBrowser()
+{
+    gImGuiDemoBrowser = nullptr;
+}
+
 void ImGuiDemoBrowser::gui()
 {
     guiHelp();
@@ -46,12 +65,12 @@ void ImGuiDemoBrowser::guiHelp()
     static bool showHelp = true;
     if (showHelp)
     {
-        std::string help =
+        const char *help =
             "This is the code of imgui_demo.cpp. It is the best way to learn about Dear ImGui! \n"
             "On the left, you can see a demo that showcases all the widgets and features of ImGui: "
             "Click on the \"Code\" buttons to see their code and learn about them. \n"
             "Alternatively, you can also search for some features (try searching for \"widgets\", \"layout\", \"drag\", etc)";
-        ImGui::TextWrapped("%s", help.c_str());
+        ImGui::TextWrapped("%s", help);
         //ImGui::SameLine();
         if (ImGui::Button(ICON_FA_THUMBS_UP " Got it"))
         showHelp = false;
@@ -64,7 +83,7 @@ void ImGuiDemoBrowser::guiSave()
     if (ImGui::Button("Save"))
         {
             std::string fileSrc = IMGUI_MANUAL_REPO_DIR "/external/imgui/imgui_demo.cpp";
-            fplus::write_text_file(fileSrc, mEditor.GetText())();
+            fplus::write_text_file(fileSrc, mEditor->GetText())();
         }
 #endif
 }
@@ -74,13 +93,14 @@ void ImGuiDemoBrowser::guiGithubButton()
     if (ImGui::SmallButton("View on github at this line"))
     {
         std::string url = ImGuiRepoUrl() + "imgui_demo.cpp#L"
-                          + std::to_string(mEditor.GetCursorPosition().mLine);
+                          + std::to_string(cursorLine());
         HyperlinkHelper::OpenUrl(url);
     }
 }
 
 void ImGuiDemoBrowser::guiDemoCodeTags()
 {
+    Profiler::ScopedTimer scopedTimer("ImGuiDemoBrowser::guiDemoCodeTags");
     bool showTooltip = false;
     ImGui::Text("Search demos"); ImGui::SameLine();
     if (ImGui::IsItemHovered())
@@ -102,19 +122,85 @@ void ImGuiDemoBrowser::guiDemoCodeTags()
         ImGui::EndTooltip();
     }
 
-    static ImGuiTextFilter filter;
-    filter.Draw();
-    if (strlen(filter.InputBuf) >= 3)
+    mTagsFilter.Draw();
+    if (strlen(mTagsFilter.InputBuf) >= 3)
+    {
+        updateMatchingTags();
+        guiMatchingTags();
+    }
+}
+
+void ImGuiDemoBrowser::updateMatchingTags()
+{
+    if (mMatchingTagsAreValid && mMatchingTagsFilterText == mTagsFilter.InputBuf)
+        return;
+    mMatchingTagsFilterText = mTagsFilter.InputBuf;
+    mMatchingTagsAreValid = true;
+
+    // The tags that pass the filter (same "-exc,inc" syntax as ImGuiTextFilter)...
+    TextSearch::Filter filter(mTagsFilter.InputBuf);
+    std::vector<int> passingTags;
+    filter.findMatchingLines(mTagsDocument, 0, mTagsDocument.nbLines(), &passingTags);
+    std::vector<bool> isPassing(mTagsDocument.nbLines(), false);
+    for (int tagIndex : passingTags)
+        isPassing[tagIndex] = true;
+
+    // ... and the tags that fuzzy match an inclusion without matching any exclusion
+    std::vector<std::string_view> inclusions, exclusions;
+    for (const auto &term : filter.terms())
+        if (!term.lowercaseText.empty())
+            (term.isExclusion ? exclusions : inclusions).push_back(term.lowercaseText);
+
+    std::vector<std::pair<int, int>> scoredTags; // (score, tag index)
+    for (int tagIndex = 0; tagIndex < mTagsDocument.nbLines(); ++tagIndex)
+    {
+        std::string_view tag = mTagsDocument.line(tagIndex);
+        int score = -1;
+        for (const auto &inclusion : inclusions)
+            score = std::max(score, FuzzyMatch::Score(inclusion, tag));
+        if (!isPassing[tagIndex])
+        {
+            if (score < 0)
+                continue;
+            bool isExcluded = false;
+            for (const auto &exclusion : exclusions)
+                if (TextSearch::Find(tag, exclusion) != std::string_view::npos)
+                    isExcluded = true;
+            if (isExcluded)
+                continue;
+        }
+        scoredTags.push_back({score, tagIndex});
+    }
+    std::stable_sort(scoredTags.begin(), scoredTags.end(),
+                     [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    mMatchingTags.clear();
+    for (const auto &scoredTag : scoredTags)
+        mMatchingTags.push_back(scoredTag.second);
+}
+
+void ImGuiDemoBrowser::guiMatchingTags()
+{
+    if (mMatchingTags.empty())
+    {
+        ImGui::TextDisabled("No demo found");
+        return;
+    }
+    // Only the visible tags are drawn
+    const int maxNbVisibleTags = 8;
+    int nbVisibleTags = std::min((int)mMatchingTags.size(), maxNbVisibleTags);
+    ImVec2 listSize(0.f, ImGui::GetTextLineHeightWithSpacing() * (float)nbVisibleTags + ImGui::GetStyle().WindowPadding.y * 2.f);
+    ImGui::BeginChild("MatchingTags", listSize, true);
+    ImGuiListClipper clipper;
+    clipper.Begin((int)mMatchingTags.size());
+    while (clipper.Step())
     {
-        for (const auto & lineWithNote : mAnnotatedSource.linesWithTags)
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
         {
-            if (filter.PassFilter(lineWithNote.tag.c_str()))
-            {
-                if (ImGui::SmallButton(lineWithNote.tag.c_str()))
-                    mEditor.SetCursorPosition({lineWithNote.lineNumber, 0}, 3);
-                ImGuiExt::SameLine_IfPossible(150.f);
-            }
+            const auto & lineWithNote = mAnnotatedSource.linesWithTags[mMatchingTags[i]];
+            if (ImGui::Selectable(lineWithNote.label.c_str()))
+                setCursorLine(lineWithNote.lineNumber, 3);
         }
-        ImGui::NewLine();
     }
+    ImGui::EndChild();
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "WindowWithEditor.h"
 #include "Sources.h"
+#include "utilities/TextSearch.h"
 
 // This is the window that shows imgui_demo.cpp code,
 // with a callback that will point to the correct line number
@@ -9,6 +10,7 @@ class ImGuiDemoBrowser: public WindowWithEditor
 {
 public:
     ImGuiDemoBrowser();
+    ~ImGuiDemoBrowser();
     void gui();
 
 private:
@@ -16,6 +18,16 @@ private:
     void guiSave();
     void guiGithubButton();
     void guiDemoCodeTags();
+    void guiMatchingTags();
+    void updateMatchingTags();
 
     Sources::AnnotatedSource mAnnotatedSource;
+    // The tags, lowercased for TextSearch (see guiDemoCodeTags)
+    TextSearch::LowercaseDocument mTagsDocument;
+    ImGuiTextFilter mTagsFilter;
+    // Indexes of the tags that match mTagsFilter, best first.
+    // They are only recomputed when the filter text or the tags change
+    std::vector<int> mMatchingTags;
+    std::string mMatchingTagsFilterText;
+    bool mMatchingTagsAreValid = false;
 };
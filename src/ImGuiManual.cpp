@@ -1,22 +1,30 @@
 #include "AboutWindow.h"
 #include "Acknowledgments.h"
+#include "CodeNavigation.h"
+#include "CodeSearchWindow.h"
 #include "ImGuiCodeBrowser.h"
 #include "ImGuiCppDocBrowser.h"
 #include "ImGuiDemoBrowser.h"
 #include "ImGuiReadmeBrowser.h"
+#include "LazyWindowRegistry.h"
 #include "MenuTheme.h"
+#include "PerformanceReport.h"
+#include "ProfilerWindow.h"
+#include "SymbolIndex.h"
+#include "utilities/FrameArena.h"
+#include "utilities/IdleThrottle.h"
+#include "utilities/Profiler.h"
+#include "utilities/WorkerPool.h"
 
 #include "hello_imgui/hello_imgui.h"
 
 int main(int, char **)
 {
-    // Our gui providers for the different windows
-    ImGuiDemoBrowser imGuiDemoBrowser;
-    ImGuiCppDocBrowser imGuiCppDocBrowser;
-    ImGuiCodeBrowser imGuiCodeBrowser;
-    ImGuiReadmeBrowser imGuiReadmeBrowser;
-    Acknowledgments acknowledgments;
-    AboutWindow aboutWindow;
+    // Our gui providers for the different windows are built
+    // the first time their window is shown (see LazyWindowRegistry)
+    LazyWindowRegistry lazyWindows;
+    PerformanceReport performanceReport(lazyWindows);
+    ProfilerWindow profilerWindow;
 
     //
     // Below, we will define all our application parameters and callbacks
@@ -63,7 +71,7 @@ int main(int, char **)
             dock_imguiDemoCode.label = "ImGui - Demo Code";
             dock_imguiDemoCode.dockSpaceName = "CodeSpace";// This window goes into "CodeSpace"
             dock_imguiDemoCode.isVisible = true;
-            dock_imguiDemoCode.GuiFonction = [&imGuiDemoBrowser] { imGuiDemoBrowser.gui(); };
+            dock_imguiDemoCode.GuiFonction = lazyWindows.lazyGui<ImGuiDemoBrowser>(dock_imguiDemoCode.label);
             dock_imguiDemoCode.imGuiWindowFlags = ImGuiWindowFlags_HorizontalScrollbar;
         };
 
@@ -72,7 +80,7 @@ int main(int, char **)
             dock_imGuiCppDocBrowser.label = "ImGui - Doc";
             dock_imGuiCppDocBrowser.dockSpaceName = "CodeSpace";
             dock_imGuiCppDocBrowser.isVisible = true;
-            dock_imGuiCppDocBrowser.GuiFonction = [&imGuiCppDocBrowser] { imGuiCppDocBrowser.gui(); };
+            dock_imGuiCppDocBrowser.GuiFonction = lazyWindows.lazyGui<ImGuiCppDocBrowser>(dock_imGuiCppDocBrowser.label);
         };
 
         HelloImGui::DockableWindow dock_imguiReadme;
@@ -80,7 +88,7 @@ int main(int, char **)
             dock_imguiReadme.label = "ImGui - Readme";
             dock_imguiReadme.dockSpaceName = "CodeSpace";
             dock_imguiReadme.isVisible = false;
-            dock_imguiReadme.GuiFonction = [&imGuiReadmeBrowser] { imGuiReadmeBrowser.gui(); };
+            dock_imguiReadme.GuiFonction = lazyWindows.lazyGui<ImGuiReadmeBrowser>(dock_imguiReadme.label, true);
         };
 
         HelloImGui::DockableWindow dock_imguiCodeBrowser;
@@ -88,7 +96,7 @@ int main(int, char **)
             dock_imguiCodeBrowser.label = "ImGui - Code";
             dock_imguiCodeBrowser.dockSpaceName = "CodeSpace";
             dock_imguiCodeBrowser.isVisible = false;
-            dock_imguiCodeBrowser.GuiFonction = [&imGuiCodeBrowser] { imGuiCodeBrowser.gui(); };
+            dock_imguiCodeBrowser.GuiFonction = lazyWindows.lazyGui<ImGuiCodeBrowser>(dock_imguiCodeBrowser.label);
         };
 
         HelloImGui::DockableWindow dock_acknowledgments;
@@ -97,7 +105,7 @@ int main(int, char **)
             dock_acknowledgments.dockSpaceName = "CodeSpace";
             dock_acknowledgments.isVisible = false;
             dock_acknowledgments.includeInViewMenu = false;
-            dock_acknowledgments.GuiFonction = [&acknowledgments] { acknowledgments.gui(); };
+            dock_acknowledgments.GuiFonction = lazyWindows.lazyGui<Acknowledgments>(dock_acknowledgments.label, true);
         };
 
         HelloImGui::DockableWindow dock_about;
@@ -106,7 +114,33 @@ int main(int, char **)
             dock_about.dockSpaceName = "CodeSpace";
             dock_about.isVisible = false;
             dock_about.includeInViewMenu = false;
-            dock_about.GuiFonction = [&aboutWindow] { aboutWindow.gui(); };
+            dock_about.GuiFonction = lazyWindows.lazyGui<AboutWindow>(dock_about.label, true);
+        };
+
+        HelloImGui::DockableWindow dock_codeSearch;
+        {
+            dock_codeSearch.label = "Search all sources";
+            dock_codeSearch.dockSpaceName = "CodeSpace";
+            dock_codeSearch.isVisible = false;
+            dock_codeSearch.GuiFonction = lazyWindows.lazyGui<CodeSearchWindow>(dock_codeSearch.label);
+        };
+
+        HelloImGui::DockableWindow dock_performanceReport;
+        {
+            dock_performanceReport.label = "Performance report";
+            dock_performanceReport.dockSpaceName = "CodeSpace";
+            dock_performanceReport.isVisible = false;
+            dock_performanceReport.includeInViewMenu = false;
+            dock_performanceReport.GuiFonction = [&performanceReport] { performanceReport.gui(); };
+        };
+
+        HelloImGui::DockableWindow dock_profiler;
+        {
+            dock_profiler.label = "Profiler";
+            dock_profiler.dockSpaceName = "CodeSpace";
+            dock_profiler.isVisible = false;
+            dock_profiler.includeInViewMenu = false;
+            dock_profiler.GuiFonction = [&profilerWindow] { profilerWindow.gui(); };
         };
 
         //
@@ -119,7 +153,25 @@ int main(int, char **)
             // dock_imguiReadme,
             dock_imguiCodeBrowser,
             dock_acknowledgments,
-            dock_about};
+            dock_about,
+            dock_codeSearch,
+            dock_performanceReport,
+            dock_profiler};
+
+        // Each window is measured by the profiler (time and allocations per frame)
+        for (auto &dockableWindow : runnerParams.dockingParams.dockableWindows)
+            dockableWindow.GuiFonction = Profiler::Wrap(dockableWindow.label, dockableWindow.GuiFonction);
+
+        // The windows that can show a given source (e.g. for a hit of the code search).
+        // imgui_demo.cpp and imgui.cpp are also in the ImGui code browser, but have their own windows.
+        CodeNavigation::RegisterSources(dock_imguiDemoCode.label, {"imgui/imgui_demo.cpp"});
+        CodeNavigation::RegisterSources(dock_imGuiCppDocBrowser.label, {"imgui/imgui.cpp"});
+        CodeNavigation::RegisterSources(dock_imguiCodeBrowser.label, Sources::librarySourcePaths(Sources::imguiLibrary()));
+        CodeNavigation::RegisterSources(dock_acknowledgments.label, Sources::librarySourcePaths(Sources::acknowldegmentLibraries()));
+        CodeNavigation::RegisterSources(dock_about.label, Sources::librarySourcePaths(Sources::imguiManualLibrary()));
+
+        // Go to definition (Ctrl+click in the editors), built in the background at the first lookup
+        SymbolIndex::SetSources(Sources::librarySourcePaths(Sources::imguiLibrary()), "imgui/imgui_demo.cpp");
     }
 
     // Set the app menu
@@ -130,16 +182,41 @@ int main(int, char **)
             runnerParams.dockingParams.dockableWindowOfName("About this manual");
           HelloImGui::DockableWindow *acknowledgmentWindow =
               runnerParams.dockingParams.dockableWindowOfName("Acknowledgments");
+        HelloImGui::DockableWindow *performanceWindow =
+            runnerParams.dockingParams.dockableWindowOfName("Performance report");
+        HelloImGui::DockableWindow *profilerWindow =
+            runnerParams.dockingParams.dockableWindowOfName("Profiler");
         if (aboutWindow && ImGui::BeginMenu("About"))
         {
             if (ImGui::MenuItem("About this manual"))
                 aboutWindow->isVisible = true;
             if (ImGui::MenuItem("Acknowledgments"))
                 acknowledgmentWindow->isVisible = true;
+            if (ImGui::MenuItem("Performance report"))
+                performanceWindow->isVisible = true;
+            if (ImGui::MenuItem("Profiler"))
+                profilerWindow->isVisible = true;
             ImGui::EndMenu();
         }
     };
 
+    // Called once per frame: start a new profiler frame and frame arena, free the lazy windows that were hidden,
+    // hand the sources loaded in the background to their windows,
+    // and show the window targeted by a CodeNavigation request
+    runnerParams.callbacks.ShowGui = [&runnerParams, &lazyWindows] {
+        // When nothing changes on screen, the loop waits here for an input (see IdleThrottle)
+        if (IdleThrottle::OnNewFrame() > 0.)
+            Profiler::DiscardFrame();
+        Profiler::OnNewFrame();
+        FrameArena::NewFrame();
+        lazyWindows.onNewFrame(runnerParams.dockingParams.dockableWindows);
+        {
+            Profiler::ScopedTimer scopedTimer("WorkerPool::ProcessFrame");
+            WorkerPool::ProcessFrame(/*timeBudgetMs=*/ 8.);
+        }
+        CodeNavigation::ShowRequestedWindow(runnerParams.dockingParams.dockableWindows);
+    };
+
     // Add some widgets in the status bar
     runnerParams.callbacks.ShowStatus = [] {
         MarkdownHelper::Markdown("Dear ImGui Manual - [Repository](https://github.com/pthom/imgui_manual)");
@@ -0,0 +1,352 @@
+#include "LargeFileView.h"
+#include "CppTokenizer.h"
+#include "EditorColorizer.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    using PaletteIndex = TextEditor::PaletteIndex;
+
+    // Above these, a source is shown by LargeFileView
+    constexpr size_t kLargeSourceMinBytes = 1024 * 1024;
+    constexpr int kLargeSourceMinLines = 20000;
+
+    constexpr int kTabSize = 4; // same as TextEditor
+
+    // A glyph byte: palette index in the low bits, then the flags of TextEditor::Glyph
+    constexpr uint8_t kPaletteMask = 0x1f;
+    constexpr uint8_t kCommentFlag = 0x20;
+    constexpr uint8_t kMultiLineCommentFlag = 0x40;
+    constexpr uint8_t kPreprocessorFlag = 0x80;
+
+    // The state at the start of a line
+    constexpr uint8_t kInBlockCommentState = 1;
+    constexpr uint8_t kInPreprocessorState = 2;
+
+    // Sets the comment and preprocessor flags of the glyphs of a line (if glyphs is not null),
+    // and returns the state at the start of the next line
+    uint8_t ScanComments(std::string_view line, uint8_t state, uint8_t *glyphs)
+    {
+        bool inBlockComment = (state & kInBlockCommentState) != 0;
+        bool isPreprocessor = (state & kInPreprocessorState) != 0;
+        if (!isPreprocessor && !inBlockComment)
+        {
+            size_t first = line.find_first_not_of(" \t");
+            isPreprocessor = (first != std::string_view::npos && line[first] == '#');
+        }
+        bool inLineComment = false;
+        bool inString = false;
+        const size_t n = line.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            const char c = line[i];
+            const bool hasNext = (i + 1 < n);
+            uint8_t flags = 0;
+            size_t nbChars = 1;
+            if (inBlockComment)
+            {
+                flags = kMultiLineCommentFlag;
+                if (c == '*' && hasNext && line[i + 1] == '/')
+                {
+                    inBlockComment = false;
+                    nbChars = 2;
+                }
+            }
+            else if (inLineComment)
+                flags = kCommentFlag;
+            else if (inString)
+            {
+                if (c == '\\' && hasNext)
+                    nbChars = 2;
+                else if (c == '"')
+                    inString = false;
+            }
+            else if (c == '"')
+                inString = true;
+            else if (c == '/' && hasNext && line[i + 1] == '/')
+            {
+                inLineComment = true;
+                flags = kCommentFlag;
+            }
+            else if (c == '/' && hasNext && line[i + 1] == '*')
+            {
+                inBlockComment = true;
+                flags = kMultiLineCommentFlag;
+                nbChars = 2;
+            }
+            if (isPreprocessor)
+                flags |= kPreprocessorFlag;
+            if (glyphs != nullptr)
+                for (size_t j = i; j < i + nbChars; ++j)
+                    glyphs[j] |= flags;
+            i += nbChars - 1;
+        }
+        uint8_t nextState = 0;
+        if (inBlockComment)
+            nextState |= kInBlockCommentState;
+        if (isPreprocessor && n > 0 && line[n - 1] == '\\')
+            nextState |= kInPreprocessorState;
+        return nextState;
+    }
+
+    // Same tokens and identifier lookups as TextEditor::ColorizeRange
+    void ColorizeLine(std::string_view line, uint8_t state, std::vector<uint8_t> *glyphs)
+    {
+        glyphs->assign(line.size(), (uint8_t)PaletteIndex::Default);
+        ScanComments(line, state, glyphs->data());
+
+        const auto &language = EditorColorizer::LanguageDefinition();
+        const char *begin = line.data();
+        const char *end = begin + line.size();
+        std::string identifier;
+        for (const char *first = begin; first < end;)
+        {
+            const char *tokenBegin = nullptr, *tokenEnd = nullptr;
+            PaletteIndex paletteIndex = PaletteIndex::Default;
+            if (!CppTokenizer::Tokenize(first, end, tokenBegin, tokenEnd, paletteIndex))
+            {
+                ++first;
+                continue;
+            }
+            uint8_t *tokenGlyphs = glyphs->data() + (tokenBegin - begin);
+            if (paletteIndex == PaletteIndex::Identifier)
+            {
+                identifier.assign(tokenBegin, tokenEnd);
+                if ((tokenGlyphs[0] & kPreprocessorFlag) == 0)
+                {
+                    if (language.mKeywords.count(identifier) != 0)
+                        paletteIndex = PaletteIndex::Keyword;
+                    else if (language.mIdentifiers.count(identifier) != 0)
+                        paletteIndex = PaletteIndex::KnownIdentifier;
+                    else if (language.mPreprocIdentifiers.count(identifier) != 0)
+                        paletteIndex = PaletteIndex::PreprocIdentifier;
+                }
+                else if (language.mPreprocIdentifiers.count(identifier) != 0)
+                    paletteIndex = PaletteIndex::PreprocIdentifier;
+            }
+            for (const char *p = tokenBegin; p < tokenEnd; ++p, ++tokenGlyphs)
+                *tokenGlyphs = (uint8_t)((*tokenGlyphs & ~kPaletteMask) | (uint8_t)paletteIndex);
+            first = std::max(tokenEnd, first + 1);
+        }
+    }
+
+    // Same as TextEditor::GetGlyphColor
+    ImU32 GlyphColor(uint8_t glyph, const TextEditor::Palette &palette)
+    {
+        if (glyph & kCommentFlag)
+            return palette[(int)PaletteIndex::Comment];
+        if (glyph & kMultiLineCommentFlag)
+            return palette[(int)PaletteIndex::MultiLineComment];
+        ImU32 color = palette[glyph & kPaletteMask];
+        if (glyph & kPreprocessorFlag)
+        {
+            // Half way between the token color and the preprocessor color
+            ImU32 preprocessorColor = palette[(int)PaletteIndex::Preprocessor];
+            ImU32 r = 0;
+            for (int shift = 0; shift < 32; shift += 8)
+                r |= ((((color >> shift) & 0xff) + ((preprocessorColor >> shift) & 0xff)) / 2) << shift;
+            return r;
+        }
+        return color;
+    }
+}
+
+bool LargeFileView::IsLargeSource(std::string_view sourceCode)
+{
+    if (sourceCode.size() >= kLargeSourceMinBytes)
+        return true;
+    return std::count(sourceCode.begin(), sourceCode.end(), '\n') >= kLargeSourceMinLines;
+}
+
+void LargeFileView::setSource(const Sources::Source &source)
+{
+    mSource = source;
+    std::string_view text = mSource.sourceCode;
+    mLineStarts.clear();
+    mLineStartStates.clear();
+    mBreakpoints.clear();
+    mWindowGlyphs.clear();
+    mWindowFirstLine = 0;
+    mCursorLine = 0;
+    mScrollRequestLine = -1;
+
+    size_t start = 0;
+    uint8_t state = 0;
+    while (true)
+    {
+        mLineStarts.push_back(start);
+        mLineStartStates.push_back(state);
+        const void *newLine = memchr(text.data() + start, '\n', text.size() - start);
+        size_t end = newLine ? (size_t)((const char *)newLine - text.data()) : text.size();
+        state = ScanComments(text.substr(start, end - start), state, nullptr);
+        if (newLine == nullptr)
+            break;
+        start = end + 1;
+    }
+    mLineStarts.push_back(text.size() + 1);
+}
+
+std::string_view LargeFileView::line(int lineIndex) const
+{
+    size_t start = mLineStarts[lineIndex];
+    size_t end = std::min(mLineStarts[lineIndex + 1] - 1, mSource.sourceCode.size());
+    // TextEditor drops '\r'
+    if (end > start && mSource.sourceCode[end - 1] == '\r')
+        --end;
+    return mSource.sourceCode.substr(start, end - start);
+}
+
+void LargeFileView::setCursorLine(int lineIndex, int cursorLineOnPage)
+{
+    mCursorLine = std::max(0, std::min(lineIndex, nbLines() - 1));
+    mScrollRequestLine = mCursorLine;
+    mScrollRequestLineOnPage = cursorLineOnPage;
+}
+
+size_t LargeFileView::memoryBytes() const
+{
+    size_t r = mLineStarts.capacity() * sizeof(size_t) + mLineStartStates.capacity();
+    for (const auto &glyphs : mWindowGlyphs)
+        r += glyphs.capacity() + sizeof(glyphs);
+    return r;
+}
+
+void LargeFileView::ensureColorizedWindow(int firstLine, int endLine)
+{
+    const int windowEnd = mWindowFirstLine + (int)mWindowGlyphs.size();
+    if (firstLine >= mWindowFirstLine && endLine <= windowEnd)
+        return;
+
+    // Keep a margin of two pages on each side, and reuse the lines that stay in the window
+    const int margin = 2 * std::max(endLine - firstLine, 32);
+    const int newFirst = std::max(0, firstLine - margin);
+    const int newEnd = std::min(nbLines(), endLine + margin);
+    std::vector<std::vector<uint8_t>> glyphs(newEnd - newFirst);
+    for (int i = newFirst; i < newEnd; ++i)
+    {
+        if (i >= mWindowFirstLine && i < windowEnd)
+            glyphs[i - newFirst] = std::move(mWindowGlyphs[i - mWindowFirstLine]);
+        else
+            ColorizeLine(line(i), mLineStartStates[i], &glyphs[i - newFirst]);
+    }
+    mWindowGlyphs = std::move(glyphs);
+    mWindowFirstLine = newFirst;
+}
+
+void LargeFileView::handleKeyboard(int nbVisibleLines)
+{
+    if (!ImGui::IsWindowFocused())
+        return;
+    int delta = 0;
+    if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_UpArrow)))
+        delta = -1;
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow)))
+        delta = 1;
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_PageUp)))
+        delta = -nbVisibleLines;
+    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_PageDown)))
+        delta = nbVisibleLines;
+    if (delta != 0)
+        setCursorLine(mCursorLine + delta);
+}
+
+void LargeFileView::applyScrollRequest(float lineHeight)
+{
+    if (mScrollRequestLine < 0)
+        return;
+    const float viewHeight = ImGui::GetWindowHeight();
+    // The content height is only known after the first frame
+    if (ImGui::GetScrollMaxY() <= 0.f && (float)nbLines() * lineHeight > viewHeight)
+        return;
+    const int nbVisibleLines = std::max(1, (int)(viewHeight / lineHeight));
+    const int firstVisibleLine = (int)(ImGui::GetScrollY() / lineHeight);
+    if (mScrollRequestLineOnPage >= 0)
+        ImGui::SetScrollY((float)std::max(0, mScrollRequestLine - mScrollRequestLineOnPage) * lineHeight);
+    else if (mScrollRequestLine < firstVisibleLine)
+        ImGui::SetScrollY((float)mScrollRequestLine * lineHeight);
+    else if (mScrollRequestLine >= firstVisibleLine + nbVisibleLines - 1)
+        ImGui::SetScrollY((float)(mScrollRequestLine - nbVisibleLines + 2) * lineHeight);
+    mScrollRequestLine = -1;
+}
+
+void LargeFileView::render(const char *title, const TextEditor::Palette &palette)
+{
+    ImGui::PushStyleColor(ImGuiCol_ChildBg, palette[(int)PaletteIndex::Background]);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0.f, 0.f));
+    ImGui::BeginChild(title, ImVec2(), false, ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoMove);
+
+    const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+    handleKeyboard(std::max(1, (int)(ImGui::GetWindowHeight() / lineHeight) - 1));
+    applyScrollRequest(lineHeight);
+
+    // Same layout as TextEditor: line numbers, then the text
+    char lineNumber[16];
+    snprintf(lineNumber, sizeof(lineNumber), "%d  ", nbLines());
+    const float lineNumberWidth = ImGui::CalcTextSize(lineNumber).x;
+    const float textStart = lineNumberWidth + ImGui::CalcTextSize(" ").x * 2.f;
+    const float tabWidth = ImGui::CalcTextSize(" ").x * (float)kTabSize;
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    ImGuiListClipper clipper;
+    clipper.Begin(nbLines(), lineHeight);
+    while (clipper.Step())
+    {
+        ensureColorizedWindow(clipper.DisplayStart, clipper.DisplayEnd);
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            const ImVec2 lineStart = ImGui::GetCursorScreenPos();
+            const float viewWidth = ImGui::GetWindowWidth() + ImGui::GetScrollX();
+            const ImVec2 lineEnd(lineStart.x + viewWidth, lineStart.y + lineHeight);
+            if (mBreakpoints.count(i + 1) != 0)
+                drawList->AddRectFilled(ImVec2(lineStart.x + lineNumberWidth, lineStart.y), lineEnd,
+                                        palette[(int)PaletteIndex::Breakpoint]);
+            if (i == mCursorLine)
+                drawList->AddRectFilled(ImVec2(lineStart.x + lineNumberWidth, lineStart.y), lineEnd,
+                                        palette[(int)PaletteIndex::CurrentLineFillInactive]);
+
+            snprintf(lineNumber, sizeof(lineNumber), "%d  ", i + 1);
+            float numberWidth = ImGui::CalcTextSize(lineNumber).x;
+            drawList->AddText(ImVec2(lineStart.x + lineNumberWidth - numberWidth, lineStart.y),
+                              palette[(int)PaletteIndex::LineNumber], lineNumber);
+
+            // Runs of glyphs of the same color
+            std::string_view text = line(i);
+            const std::vector<uint8_t> &glyphs = mWindowGlyphs[i - mWindowFirstLine];
+            float x = textStart;
+            size_t runStart = 0;
+            for (size_t j = 0; j <= text.size(); ++j)
+            {
+                bool endsRun = (j == text.size()) || text[j] == '\t' || glyphs[j] != glyphs[runStart];
+                if (!endsRun)
+                    continue;
+                if (j > runStart)
+                {
+                    const char *runBegin = text.data() + runStart, *runEnd = text.data() + j;
+                    drawList->AddText(ImVec2(lineStart.x + x, lineStart.y), GlyphColor(glyphs[runStart], palette),
+                                      runBegin, runEnd);
+                    x += ImGui::CalcTextSize(runBegin, runEnd).x;
+                }
+                runStart = j;
+                if (j < text.size() && text[j] == '\t')
+                {
+                    x = (1.f + std::floor((1.f + x - textStart) / tabWidth)) * tabWidth + textStart;
+                    runStart = j + 1;
+                }
+            }
+
+            ImGui::Dummy(ImVec2(std::max(x, ImGui::GetContentRegionAvail().x), lineHeight));
+            if (ImGui::IsItemClicked())
+                mCursorLine = i;
+        }
+    }
+    clipper.End();
+
+    ImGui::EndChild();
+    ImGui::PopStyleVar();
+    ImGui::PopStyleColor();
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Sources.h"
+#include "TextEditor.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// LargeFileView is the read-only view used by WindowWithEditor for large sources
+// (see IsLargeSource), where a TextEditor would store one std::vector<Glyph> per line.
+//
+// It keeps the raw text of the source (whose buffer may be memory mapped), the offsets
+// of its lines, and the comment state at the start of each line. Glyph colors are only
+// computed for a sliding window of lines around the viewport (with CppTokenizer).
+class LargeFileView
+{
+public:
+    static bool IsLargeSource(std::string_view sourceCode);
+
+    void setSource(const Sources::Source &source);
+    // Lines are highlighted like TextEditor breakpoints (e.g. the tags of annotated sources)
+    void setBreakpoints(const std::unordered_set<int> &lines) { mBreakpoints = lines; }
+    void render(const char *title, const TextEditor::Palette &palette);
+
+    std::string_view text() const { return mSource.sourceCode; }
+    int nbLines() const { return (int)mLineStarts.size() - 1; }
+    std::string_view line(int lineIndex) const;
+
+    int cursorLine() const { return mCursorLine; }
+    // Moves the cursor and scrolls to it: with cursorLineOnPage >= 0, the line is shown
+    // at this position from the top of the view (like TextEditor::SetCursorPosition)
+    void setCursorLine(int lineIndex, int cursorLineOnPage = -1);
+
+    size_t memoryBytes() const;
+
+private:
+    void ensureColorizedWindow(int firstLine, int endLine);
+    void handleKeyboard(int nbVisibleLines);
+    void applyScrollRequest(float lineHeight);
+
+    Sources::Source mSource;
+    std::vector<size_t> mLineStarts;     // nbLines + 1 entries: the last one is past the end
+    std::vector<uint8_t> mLineStartStates; // the comment / preprocessor state at the start of each line
+    std::unordered_set<int> mBreakpoints;
+
+    // The glyphs of lines [mWindowFirstLine, mWindowFirstLine + mWindowGlyphs.size()):
+    // one byte per character, with its palette index and comment / preprocessor flags
+    int mWindowFirstLine = 0;
+    std::vector<std::vector<uint8_t>> mWindowGlyphs;
+
+    int mCursorLine = 0;
+    int mScrollRequestLine = -1;
+    int mScrollRequestLineOnPage = -1;
+};
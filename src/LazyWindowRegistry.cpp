@@ -0,0 +1,58 @@
+#include "LazyWindowRegistry.h"
+
+namespace
+{
+    double durationMs(std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+}
+
+LazyWindowRegistry::LazyWindowRegistry()
+    : mCreationTime(Clock::now())
+{
+}
+
+LazyWindowRegistry::Entry *LazyWindowRegistry::addEntry(const std::string &windowLabel, bool freeWhenHidden)
+{
+    auto entry = std::make_unique<Entry>();
+    entry->info.label = windowLabel;
+    entry->info.freeWhenHidden = freeWhenHidden;
+    mEntries.push_back(std::move(entry));
+    return mEntries.back().get();
+}
+
+void LazyWindowRegistry::onBuilt(Entry *entry, Clock::time_point buildStart)
+{
+    entry->info.isBuilt = true;
+    entry->info.nbBuilds++;
+    entry->info.lastBuildDurationMs = durationMs(Clock::now() - buildStart);
+}
+
+void LazyWindowRegistry::onNewFrame(const std::vector<HelloImGui::DockableWindow> &dockableWindows)
+{
+    if (mTimeToFirstFrameMs < 0.)
+        mTimeToFirstFrameMs = durationMs(Clock::now() - mCreationTime);
+
+    for (auto &entry : mEntries)
+    {
+        if (!entry->instance || !entry->info.freeWhenHidden)
+            continue;
+        for (const auto &dockableWindow : dockableWindows)
+        {
+            if (dockableWindow.label == entry->info.label && !dockableWindow.isVisible)
+            {
+                entry->instance.reset();
+                entry->info.isBuilt = false;
+            }
+        }
+    }
+}
+
+std::vector<LazyWindowRegistry::WindowInfo> LazyWindowRegistry::windowInfos() const
+{
+    std::vector<WindowInfo> r;
+    for (const auto &entry : mEntries)
+        r.push_back(entry->info);
+    return r;
+}
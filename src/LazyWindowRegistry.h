@@ -0,0 +1,69 @@
+#pragma once
+#include "hello_imgui/hello_imgui.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// LazyWindowRegistry builds the gui providers of the dockable windows
+// (ImGuiDemoBrowser, LibrariesCodeBrowser, etc.) the first time their window
+// is shown, instead of building them all before the first frame.
+// It can also free a provider when its window is hidden, and remembers
+// how long each provider took to build (see PerformanceReport)
+class LazyWindowRegistry
+{
+public:
+    struct WindowInfo
+    {
+        std::string label;
+        bool freeWhenHidden = false;
+        bool isBuilt = false;
+        int nbBuilds = 0;
+        double lastBuildDurationMs = 0.;
+    };
+
+    LazyWindowRegistry();
+
+    // Returns a gui function for a DockableWindow: T is built with its default
+    // constructor on the first call, and then T::gui() is called.
+    template <typename T>
+    std::function<void(void)> lazyGui(const std::string &windowLabel, bool freeWhenHidden = false);
+
+    // Call this once per frame: frees the hidden windows (if freeWhenHidden)
+    void onNewFrame(const std::vector<HelloImGui::DockableWindow> &dockableWindows);
+
+    std::vector<WindowInfo> windowInfos() const;
+    double timeToFirstFrameMs() const { return mTimeToFirstFrameMs; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Entry
+    {
+        WindowInfo info;
+        std::shared_ptr<void> instance;
+    };
+
+    Entry *addEntry(const std::string &windowLabel, bool freeWhenHidden);
+    static void onBuilt(Entry *entry, Clock::time_point buildStart);
+
+    std::vector<std::unique_ptr<Entry>> mEntries;
+    Clock::time_point mCreationTime;
+    double mTimeToFirstFrameMs = -1.;
+};
+
+
+template <typename T>
+std::function<void(void)> LazyWindowRegistry::lazyGui(const std::string &windowLabel, bool freeWhenHidden)
+{
+    Entry *entry = addEntry(windowLabel, freeWhenHidden);
+    return [entry] {
+        if (!entry->instance)
+        {
+            auto buildStart = Clock::now();
+            entry->instance = std::make_shared<T>();
+            onBuilt(entry, buildStart);
+        }
+        static_cast<T *>(entry->instance.get())->gui();
+    };
+}
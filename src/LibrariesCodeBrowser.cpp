@@ -1,74 +1,84 @@
 #include "LibrariesCodeBrowser.h"
+#include "CodeNavigation.h"
+#include "SourceCache.h"
+#include "utilities/FrameArena.h"
+#include "utilities/ImageService.h"
 #include "utilities/MarkdownHelper.h"
 #include "utilities/ImGuiExt.h"
-#include "hello_imgui/hello_imgui.h"
-#include <fplus/fplus.hpp>
 
-void DrawImage_FixedWith(const HelloImGui::ImageGlPtr& image, float width)
+namespace
 {
-    float ratio = width / image->imageSize.x;
-    ImVec2 size(image->imageSize.x * ratio, image->imageSize.y * ratio);
-    ImGui::Image(image->imTextureId, size);
+    bool EndsWith(std::string_view s, std::string_view suffix)
+    {
+        return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+    }
 }
 
 LibrariesCodeBrowser::LibrariesCodeBrowser(
+    std::string windowName,
     const std::vector<Sources::Library> &librarySources,
     std::string currentSourcePath)
-        : WindowWithEditor()
+        : WindowWithEditor(std::move(windowName))
         , mLibraries(librarySources)
 {
+    for (const auto &library : mLibraries)
+    {
+        std::vector<SourceButton> buttons;
+        for (const auto &source : library.sourcePaths)
+            buttons.push_back({library.path + "/" + source, source + "##" + library.path, source});
+        mSourceButtons.push_back(std::move(buttons));
+    }
     if (!currentSourcePath.empty())
-        mCurrentSource = Sources::ReadSource(currentSourcePath);
-    mEditor.SetText(mCurrentSource.sourceCode);
+        showSource(currentSourcePath);
+}
+
+void LibrariesCodeBrowser::showSource(const std::string &sourcePath)
+{
+    mCurrentSource = SourceCache::GetSource(sourcePath);
+    size_t lastSlash = sourcePath.rfind('/');
+    mCurrentAssetDir = "code/" + (lastSlash == std::string::npos ? std::string() : sourcePath.substr(0, lastSlash));
+    setEditorSource(mCurrentSource);
 }
 
 void LibrariesCodeBrowser::gui()
 {
-    if (guiSelectLibrarySource())
-        mEditor.SetText(mCurrentSource.sourceCode);
+    guiSelectLibrarySource();
 
-    std::string sourcePath = mCurrentSource.sourcePath;
-    if (fplus::is_suffix_of(std::string(".md"), sourcePath))
-        MarkdownHelper::Markdown(mCurrentSource.sourceCode);
-    else if (fplus::is_suffix_of(std::string(".png"), sourcePath))
+    CodeNavigation::Request request;
+    if (CodeNavigation::TakeRequestForCurrentWindow(&request))
     {
-        if (mTextureCache.find(sourcePath) == mTextureCache.end())
-        {
-            std::string assetPath = std::string("code/") + sourcePath.c_str();
-            mTextureCache[sourcePath] = HelloImGui::ImageGl::FactorImage(assetPath.c_str());
-        }
-
-        DrawImage_FixedWith(mTextureCache[sourcePath], ImGui::GetWindowSize().x - 30.f);
+        if (request.sourcePath != mCurrentSource.sourcePath)
+            showSource(request.sourcePath);
+        setCursorLine(request.lineNumber, 3);
     }
+
+    const std::string &sourcePath = mCurrentSource.sourcePath;
+    if (EndsWith(sourcePath, ".md"))
+        MarkdownHelper::Markdown(mCurrentSource.sourceCode, mCurrentAssetDir);
+    else if (EndsWith(sourcePath, ".png"))
+        ImageService::ImageFixedWidth(FrameArena::Concat({"code/", sourcePath}), ImGui::GetWindowSize().x - 30.f);
     else
-        RenderEditor(mCurrentSource.sourcePath.c_str());
+        RenderEditor(sourcePath.c_str());
 }
 
-bool LibrariesCodeBrowser::guiSelectLibrarySource()
+void LibrariesCodeBrowser::guiSelectLibrarySource()
 {
-    bool changed = false;
-    for (const auto & librarySource: mLibraries)
+    for (size_t i = 0; i < mLibraries.size(); ++i)
     {
+        const auto & librarySource = mLibraries[i];
         ImGui::Text("%s", librarySource.name.c_str());
         ImGui::SameLine(ImGui::GetWindowSize().x - 350.f );
         ImGuiExt::Hyperlink(librarySource.url);
         MarkdownHelper::Markdown(librarySource.shortDoc);
-        for (const auto & source: librarySource.sourcePaths)
+        for (const auto & button: mSourceButtons[i])
         {
-            std::string currentSourcePath = librarySource.path + "/" + source;
-            bool isSelected = (currentSourcePath == mCurrentSource.sourcePath);
-            std::string buttonLabel = source + "##" + librarySource.path;
-            if (isSelected)
-                ImGui::TextDisabled("%s", source.c_str());
-            else if (ImGui::Button(buttonLabel.c_str()))
-            {
-                mCurrentSource = Sources::ReadSource(currentSourcePath);
-                changed = true;
-            }
+            if (mCurrentSource.sourcePath == button.sourcePath)
+                ImGui::TextDisabled("%s", button.name.c_str());
+            else if (ImGui::Button(button.label.c_str()))
+                showSource(button.sourcePath);
             ImGuiExt::SameLine_IfPossible(150.f);
         }
         ImGui::NewLine();
         ImGui::Separator();
     }
-    return changed;
 }
@@ -1,22 +1,32 @@
 #pragma once
 #include "Sources.h"
 #include "WindowWithEditor.h"
-#include "hello_imgui/hello_imgui.h"
-#include <unordered_map>
 
 
 class LibrariesCodeBrowser: public WindowWithEditor
 {
 public:
     LibrariesCodeBrowser(
+        std::string windowName,
         const std::vector<Sources::Library>& librarySources,
         std::string currentSourcePath
     );
     void gui();
 private:
-    bool guiSelectLibrarySource();
+    void guiSelectLibrarySource();
+    // The source and its editor come from SourceCache (see WindowWithEditor::setEditorSource)
+    void showSource(const std::string &sourcePath);
+
+    // The buttons of the sources of a library, built once in the constructor
+    struct SourceButton
+    {
+        std::string sourcePath; // e.g. "imgui/imgui.h"
+        std::string label;      // e.g. "imgui.h##imgui"
+        std::string name;       // e.g. "imgui.h"
+    };
 
     std::vector<Sources::Library> mLibraries;
-    std::unordered_map<std::string, HelloImGui::ImageGlPtr> mTextureCache;
+    std::vector<std::vector<SourceButton>> mSourceButtons; // per library
     Sources::Source mCurrentSource;
+    std::string mCurrentAssetDir; // e.g. "code/imgui", where the images of a markdown source are
 };
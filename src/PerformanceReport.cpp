@@ -0,0 +1,211 @@
+#include "PerformanceReport.h"
+#include "AssetPack.h"
+#include "SourceBuffer.h"
+#include "SourceCache.h"
+#include "SymbolIndex.h"
+#include "utilities/ArtifactCache.h"
+#include "utilities/FontAtlasCache.h"
+#include "utilities/IdleThrottle.h"
+#include "utilities/ImageService.h"
+#include "utilities/MarkdownHelper.h"
+#include "utilities/MemoryUsage.h"
+#include "imgui.h"
+
+namespace
+{
+    void TextMegaBytes(const char *label, size_t nbBytes)
+    {
+        if (nbBytes == 0)
+            ImGui::Text("%s: n/a", label);
+        else
+            ImGui::Text("%s: %.1f MB", label, (double)nbBytes / (1024. * 1024.));
+    }
+}
+
+PerformanceReport::PerformanceReport(const LazyWindowRegistry &lazyWindowRegistry)
+    : mLazyWindowRegistry(lazyWindowRegistry)
+{
+}
+
+void PerformanceReport::gui()
+{
+    guiStartup();
+    guiFrameRate();
+    guiMemory();
+    guiMarkdownCache();
+    guiSourceCache();
+    guiImageCache();
+    guiArtifactCache();
+    guiSymbolIndex();
+}
+
+void PerformanceReport::guiFrameRate()
+{
+    if (!ImGui::CollapsingHeader("Frame rate"))
+        return;
+
+    auto stats = IdleThrottle::GetStats();
+    ImGui::Text("%.0f fps, cpu %.1f%% (last second)", stats.fps, stats.cpuPercent);
+    ImGui::Text("Idle frames: %d, active frames: %d", stats.nbIdleFrames, stats.nbActiveFrames);
+    ImGui::TextDisabled("Leave the mouse still to compare the cpu use when idle, with and without throttling");
+
+    bool isEnabled = IdleThrottle::IsEnabled();
+    if (ImGui::Checkbox("Lower the frame rate when idle", &isEnabled))
+        IdleThrottle::SetEnabled(isEnabled);
+    float idleFps = IdleThrottle::GetIdleFps();
+    ImGui::SetNextItemWidth(200.f);
+    if (ImGui::SliderFloat("Idle fps (0: wait for an input)", &idleFps, 0.f, 30.f, "%.0f"))
+        IdleThrottle::SetIdleFps(idleFps);
+}
+
+void PerformanceReport::guiStartup()
+{
+    if (!ImGui::CollapsingHeader("Startup", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    ImGui::Text("Time to first frame: %.1f ms", mLazyWindowRegistry.timeToFirstFrameMs());
+    auto fontStats = FontAtlasCache::GetStats();
+    ImGui::Text("Font atlas: %s in %.1f ms, %dx%d texture, %d glyphs (%.1f KB)",
+                fontStats.wasRestored ? "restored from the cache" : "built", fontStats.loadMs,
+                fontStats.textureWidth, fontStats.textureHeight, fontStats.nbGlyphs,
+                (double)fontStats.glyphTablesBytes / 1024.);
+    ImGui::TextDisabled("Windows are built the first time they are shown");
+
+    ImGui::Columns(4, "startup_windows");
+    ImGui::Text("Window"); ImGui::NextColumn();
+    ImGui::Text("Status"); ImGui::NextColumn();
+    ImGui::Text("Last build (ms)"); ImGui::NextColumn();
+    ImGui::Text("Nb builds"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (const auto &windowInfo : mLazyWindowRegistry.windowInfos())
+    {
+        ImGui::Text("%s", windowInfo.label.c_str()); ImGui::NextColumn();
+        if (windowInfo.isBuilt)
+            ImGui::Text("built");
+        else if (windowInfo.nbBuilds > 0)
+            ImGui::TextDisabled("freed");
+        else
+            ImGui::TextDisabled("not built yet");
+        ImGui::NextColumn();
+        if (windowInfo.nbBuilds > 0)
+            ImGui::Text("%.1f", windowInfo.lastBuildDurationMs);
+        ImGui::NextColumn();
+        ImGui::Text("%d", windowInfo.nbBuilds); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+void PerformanceReport::guiMemory()
+{
+    if (!ImGui::CollapsingHeader("Memory", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    TextMegaBytes("Current RSS", MemoryUsage::CurrentRssBytes());
+    TextMegaBytes("Peak RSS", MemoryUsage::PeakRssBytes());
+    ImGui::TextDisabled("Open all the browsers to compare the peak RSS between versions");
+
+    auto sourceStats = SourceBuffer::GetStats();
+    ImGui::Text("Source buffers: %d", sourceStats.nbLiveBuffers);
+    TextMegaBytes("Source buffers size", sourceStats.nbLiveBytes);
+    TextMegaBytes("    of which memory mapped", sourceStats.nbMappedBytes);
+    auto packStats = AssetPack::GetStats();
+    if (packStats.hasPack)
+    {
+        ImGui::Text("Asset pack: %d files, %d decompressed", packStats.nbFiles, packStats.nbDecompressions);
+        TextMegaBytes("    packed size", packStats.nbPackedBytes);
+        TextMegaBytes("    unpacked size", packStats.nbUnpackedBytes);
+    }
+}
+
+void PerformanceReport::guiMarkdownCache()
+{
+    if (!ImGui::CollapsingHeader("Markdown cache"))
+        return;
+
+    auto stats = MarkdownHelper::GetCacheStats();
+    ImGui::Text("Cached documents: %d (%d blocks)", stats.nbDocuments, stats.nbBlocks);
+    ImGui::Text("Cache size: %.1f KB", (double)stats.nbBytes / 1024.);
+    int nbCalls = stats.nbHits + stats.nbMisses;
+    ImGui::Text("Hit rate: %.1f%% (%d hits, %d misses)",
+                nbCalls > 0 ? 100. * (double)stats.nbHits / (double)nbCalls : 0.,
+                stats.nbHits, stats.nbMisses);
+    ImGui::Text("Blocks rendered during the previous frame: %d (%d skipped)",
+                stats.nbBlocksRendered, stats.nbBlocksSkipped);
+}
+
+void PerformanceReport::guiSourceCache()
+{
+    if (!ImGui::CollapsingHeader("Source cache"))
+        return;
+
+    auto stats = SourceCache::GetStats();
+    ImGui::Text("Cached sources: %d (%d with their editor)", stats.nbSources, stats.nbEditors);
+    TextMegaBytes("Cache size", stats.nbBytes);
+    ImGui::Text("Sources: %d hits, %d misses", stats.nbSourceHits, stats.nbSourceMisses);
+    ImGui::Text("Editors: %d hits, %d misses", stats.nbEditorHits, stats.nbEditorMisses);
+
+    const size_t megaByte = 1024 * 1024;
+    int budgetMegaBytes = (int)(SourceCache::GetByteBudget() / megaByte);
+    ImGui::SetNextItemWidth(200.f);
+    if (ImGui::SliderInt("Budget (MB)", &budgetMegaBytes, 0, 512))
+        SourceCache::SetByteBudget((size_t)budgetMegaBytes * megaByte);
+}
+
+void PerformanceReport::guiImageCache()
+{
+    if (!ImGui::CollapsingHeader("Image cache"))
+        return;
+
+    auto stats = ImageService::GetStats();
+    ImGui::Text("Images: %d (%d textures)", stats.nbImages, stats.nbTextures);
+    TextMegaBytes("Textures size", stats.nbBytes);
+    ImGui::Text("Decodes: %d (%d failed), evictions: %d", stats.nbDecodes, stats.nbFailures, stats.nbEvictions);
+
+    const size_t megaByte = 1024 * 1024;
+    int budgetMegaBytes = (int)(ImageService::GetByteBudget() / megaByte);
+    ImGui::SetNextItemWidth(200.f);
+    if (ImGui::SliderInt("Budget (MB)##images", &budgetMegaBytes, 0, 256))
+        ImageService::SetByteBudget((size_t)budgetMegaBytes * megaByte);
+}
+
+void PerformanceReport::guiArtifactCache()
+{
+    if (!ImGui::CollapsingHeader("Artifact cache (on disk)"))
+        return;
+
+    auto stats = ArtifactCache::GetStats();
+    ImGui::Text("Hits: %d, misses: %d (of which stale or corrupted: %d)", stats.nbHits, stats.nbMisses, stats.nbCorrupted);
+    ImGui::Text("Stores: %d, evictions: %d", stats.nbStores, stats.nbEvictions);
+    ImGui::Text("Time spent: %.1f ms loading, %.1f ms storing", stats.loadMs, stats.storeMs);
+    ImGui::Text("Files: %d (as of the last store)", stats.nbFiles);
+    TextMegaBytes("Files size", stats.nbBytes);
+    ImGui::TextDisabled("Restart the manual to compare a warm start with a cold one (after \"Clear\")");
+
+    const size_t megaByte = 1024 * 1024;
+    int budgetMegaBytes = (int)(ArtifactCache::GetByteBudget() / megaByte);
+    ImGui::SetNextItemWidth(200.f);
+    if (ImGui::SliderInt("Budget (MB)##artifacts", &budgetMegaBytes, 0, 256))
+        ArtifactCache::SetByteBudget((size_t)budgetMegaBytes * megaByte);
+    if (ImGui::Button("Clear##artifacts"))
+        ArtifactCache::Clear();
+}
+
+void PerformanceReport::guiSymbolIndex()
+{
+    if (!ImGui::CollapsingHeader("Symbol index"))
+        return;
+
+    if (SymbolIndex::IsBuilding())
+    {
+        ImGui::TextDisabled("Being built...");
+        return;
+    }
+    if (!SymbolIndex::IsReady())
+    {
+        ImGui::TextDisabled("Not built yet: it is built at the first symbol lookup (e.g. Ctrl+click in an editor)");
+        return;
+    }
+    auto stats = SymbolIndex::GetStats();
+    ImGui::Text("%zu symbols in %d files, built in %.1f ms", stats.nbSymbols, stats.nbFiles, stats.buildDurationMs);
+    TextMegaBytes("Table size", stats.nbBytes);
+}
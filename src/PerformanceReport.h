@@ -0,0 +1,23 @@
+#pragma once
+#include "LazyWindowRegistry.h"
+
+// This window shows some performance figures about the manual itself:
+// time to first frame, how long each window took to build, memory usage and caches.
+class PerformanceReport
+{
+public:
+    PerformanceReport(const LazyWindowRegistry &lazyWindowRegistry);
+    void gui();
+
+private:
+    void guiStartup();
+    void guiFrameRate();
+    void guiMemory();
+    void guiMarkdownCache();
+    void guiSourceCache();
+    void guiImageCache();
+    void guiArtifactCache();
+    void guiSymbolIndex();
+
+    const LazyWindowRegistry &mLazyWindowRegistry;
+};
@@ -0,0 +1,125 @@
+#include "ProfilerWindow.h"
+#include "utilities/CacheDir.h"
+#include "utilities/FrameArena.h"
+#include "imgui.h"
+#include <algorithm>
+
+namespace
+{
+    std::string TracePath()
+    {
+        std::string dir = CacheDir::Path();
+        return dir.empty() ? "imgui_manual_trace.json" : dir + "/imgui_manual_trace.json";
+    }
+}
+
+void ProfilerWindow::gui()
+{
+    Profiler::GetScopeStats(&mScopeStats);
+    guiFrameAllocations();
+    guiTrace();
+    guiScopes();
+}
+
+void ProfilerWindow::guiFrameAllocations()
+{
+    if (!ImGui::CollapsingHeader("Frame allocations", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    for (const auto &scope : mScopeStats)
+        if (scope.name == "Frame")
+            ImGui::Text("Heap allocations during the last frame: %d", (int)scope.lastNbAllocations);
+    ImGui::TextDisabled("When the manual is idle, this should be 0: temporary strings go to the frame arena");
+    auto arenaStats = FrameArena::GetStats();
+    ImGui::Text("Frame arena: %.1f KB used during the last frame, capacity %.1f KB, %d overflow blocks",
+                (double)arenaStats.nbUsedBytes / 1024., (double)arenaStats.capacityBytes / 1024.,
+                arenaStats.nbOverflowBlocks);
+}
+
+void ProfilerWindow::guiTrace()
+{
+    if (!ImGui::CollapsingHeader("Chrome trace", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    if (Profiler::IsTracing())
+    {
+        if (ImGui::Button("Stop recording"))
+            Profiler::StopTrace();
+    }
+    else if (ImGui::Button("Start recording"))
+    {
+        Profiler::StartTrace();
+        mExportMessage.clear();
+    }
+    ImGui::SameLine();
+    ImGui::Text("%d events", (int)Profiler::NbTraceEvents());
+    if (!Profiler::IsTracing() && Profiler::NbTraceEvents() > 0)
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Export"))
+        {
+            std::string path = TracePath();
+            if (Profiler::ExportChromeTrace(path))
+                mExportMessage = "Saved " + path + " (open it with chrome://tracing or https://ui.perfetto.dev)";
+            else
+                mExportMessage = "Could not write " + path;
+        }
+    }
+    if (!mExportMessage.empty())
+        ImGui::TextWrapped("%s", mExportMessage.c_str());
+}
+
+void ProfilerWindow::guiScopes()
+{
+    if (!ImGui::CollapsingHeader("Scopes", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    auto &scopes = mScopeStats;
+    if (scopes.empty())
+    {
+        ImGui::TextDisabled("No data yet");
+        return;
+    }
+    ImGui::Checkbox("Slowest first", &mSortBySlowest);
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Reset"))
+        Profiler::ResetStats();
+    ImGui::TextDisabled("Milliseconds per frame, over the last frames where each scope ran");
+    if (mSortBySlowest)
+        std::sort(scopes.begin(), scopes.end(), [](const auto &a, const auto &b) {
+            return (a.p95Ms != b.p95Ms) ? (a.p95Ms > b.p95Ms) : (a.name < b.name);
+        });
+
+    ImGui::Columns(8, "profiler_scopes");
+    ImGui::Text("Scope"); ImGui::NextColumn();
+    ImGui::Text("History"); ImGui::NextColumn();
+    ImGui::Text("Last"); ImGui::NextColumn();
+    ImGui::Text("p50"); ImGui::NextColumn();
+    ImGui::Text("p95"); ImGui::NextColumn();
+    ImGui::Text("p99"); ImGui::NextColumn();
+    ImGui::Text("Max"); ImGui::NextColumn();
+    ImGui::Text("Allocations / frame"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (const auto &scope : scopes)
+    {
+        ImGui::PushID(scope.name.c_str());
+        if (scope.nbCalls > 1)
+            ImGui::Text("%s (x%d)", scope.name.c_str(), scope.nbCalls);
+        else
+            ImGui::Text("%s", scope.name.c_str());
+        ImGui::NextColumn();
+        ImGui::SetNextItemWidth(-1.f);
+        ImGui::PlotHistogram("##history", scope.historyMs.data(), (int)scope.historyMs.size(), 0, nullptr,
+                             0.f, scope.maxMs, ImVec2(0.f, ImGui::GetTextLineHeight()));
+        ImGui::NextColumn();
+        ImGui::Text("%.2f", scope.lastMs); ImGui::NextColumn();
+        ImGui::Text("%.2f", scope.p50Ms); ImGui::NextColumn();
+        ImGui::Text("%.2f", scope.p95Ms); ImGui::NextColumn();
+        ImGui::Text("%.2f", scope.p99Ms); ImGui::NextColumn();
+        ImGui::Text("%.2f", scope.maxMs); ImGui::NextColumn();
+        ImGui::Text("%.1f (%.1f KB)", scope.nbAllocationsPerFrame, scope.allocatedBytesPerFrame / 1024.f);
+        ImGui::NextColumn();
+        ImGui::PopID();
+    }
+    ImGui::Columns(1);
+}
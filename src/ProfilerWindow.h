@@ -0,0 +1,22 @@
+#pragma once
+#include "utilities/Profiler.h"
+#include <string>
+#include <vector>
+
+// This window shows the figures of the Profiler: the time spent and the allocations
+// made per frame by each dockable window (and by a few inner scopes, e.g. the search
+// in the editors), and can record a Chrome trace.
+class ProfilerWindow
+{
+public:
+    void gui();
+
+private:
+    void guiFrameAllocations();
+    void guiTrace();
+    void guiScopes();
+
+    std::vector<Profiler::ScopeStats> mScopeStats; // reused from frame to frame
+    bool mSortBySlowest = true;
+    std::string mExportMessage;
+};
@@ -0,0 +1,166 @@
+#include "hello_imgui/hello_imgui_assets.h"
+#include "SourceBuffer.h"
+#include "AssetPack.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define SOURCEBUFFER_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Buffers may be created from the WorkerPool threads
+    std::atomic<int> gNbLiveBuffers{0};
+    std::atomic<size_t> gNbLiveBytes{0};
+    std::atomic<size_t> gNbMappedBytes{0};
+
+    class AssetSourceBuffer : public SourceBuffer
+    {
+    public:
+        AssetSourceBuffer(HelloImGui::AssetFileData assetData, bool isText)
+            : SourceBuffer(
+                  (const char *)assetData.data,
+                  // LoadAssetFileData may or may not count a trailing zero
+                  isText ? strnlen((const char *)assetData.data, assetData.dataSize) : assetData.dataSize,
+                  false)
+            , mAssetData(assetData)
+        {
+        }
+        ~AssetSourceBuffer() override
+        {
+            HelloImGui::FreeAssetFileData(&mAssetData);
+        }
+
+    private:
+        HelloImGui::AssetFileData mAssetData;
+    };
+
+    class HeapSourceBuffer : public SourceBuffer
+    {
+    public:
+        HeapSourceBuffer(std::unique_ptr<char[]> bytes, size_t size)
+            : SourceBuffer(bytes.get(), size, false)
+            , mBytes(std::move(bytes))
+        {
+        }
+
+    private:
+        std::unique_ptr<char[]> mBytes;
+    };
+
+    bool AssetFileExists(const std::string &assetPath)
+    {
+        FILE *f = fopen(HelloImGui::assetFileFullPath(assetPath).c_str(), "rb");
+        if (f == nullptr)
+            return false;
+        fclose(f);
+        return true;
+    }
+
+#ifdef SOURCEBUFFER_USE_MMAP
+    class MappedSourceBuffer : public SourceBuffer
+    {
+    public:
+        MappedSourceBuffer(const char *data, size_t size)
+            : SourceBuffer(data, size, true)
+        {
+        }
+        ~MappedSourceBuffer() override
+        {
+            munmap((void *)mData, mSize);
+        }
+    };
+
+    std::shared_ptr<const SourceBuffer> TryMapFile(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+        struct stat st;
+        void *data = MAP_FAILED;
+        // mmap refuses empty files: those will use the asset path
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return nullptr;
+        return std::make_shared<MappedSourceBuffer>((const char *)data, (size_t)st.st_size);
+    }
+#endif
+} // namespace
+
+
+SourceBuffer::SourceBuffer(const char *data, size_t size, bool isMapped)
+    : mData(data), mSize(size), mIsMapped(isMapped)
+{
+    gNbLiveBuffers++;
+    gNbLiveBytes += mSize;
+    if (mIsMapped)
+        gNbMappedBytes += mSize;
+}
+
+SourceBuffer::~SourceBuffer()
+{
+    gNbLiveBuffers--;
+    gNbLiveBytes -= mSize;
+    if (mIsMapped)
+        gNbMappedBytes -= mSize;
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::FromAsset(const std::string &assetPath)
+{
+    if (auto packed = AssetPack::TryReadAsset(assetPath))
+        return packed;
+#ifdef SOURCEBUFFER_USE_MMAP
+    if (auto mapped = TryMapFile(HelloImGui::assetFileFullPath(assetPath)))
+        return mapped;
+#endif
+    auto assetData = HelloImGui::LoadAssetFileData(assetPath.c_str());
+    assert(assetData.data != nullptr);
+    return std::make_shared<AssetSourceBuffer>(assetData, true);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::TryFromAsset(const std::string &assetPath)
+{
+    if (auto packed = AssetPack::TryReadAsset(assetPath))
+        return packed;
+    if (!AssetFileExists(assetPath))
+        return nullptr;
+    return FromAsset(assetPath);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::TryFromAssetFile(const std::string &assetPath)
+{
+    if (!AssetFileExists(assetPath))
+        return nullptr;
+#ifdef SOURCEBUFFER_USE_MMAP
+    if (auto mapped = TryMapFile(HelloImGui::assetFileFullPath(assetPath)))
+        return mapped;
+#endif
+    auto assetData = HelloImGui::LoadAssetFileData(assetPath.c_str());
+    if (assetData.data == nullptr)
+        return nullptr;
+    return std::make_shared<AssetSourceBuffer>(assetData, false);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::FromBytes(std::unique_ptr<char[]> bytes, size_t size)
+{
+    return std::make_shared<HeapSourceBuffer>(std::move(bytes), size);
+}
+
+SourceBuffer::Stats SourceBuffer::GetStats()
+{
+    Stats r;
+    r.nbLiveBuffers = gNbLiveBuffers;
+    r.nbLiveBytes = gNbLiveBytes;
+    r.nbMappedBytes = gNbMappedBytes;
+    return r;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// SourceBuffer owns the immutable bytes of an asset file, without copying them:
+// - on linux and macOS, the file is memory mapped
+// - otherwise (emscripten, windows), the buffer keeps the data given by HelloImGui::LoadAssetFileData
+// - the code assets packed into "code.pack" are decompressed into a buffer of their own (see AssetPack)
+// All views on a source (Source::sourceCode, etc.) point inside this buffer.
+class SourceBuffer
+{
+public:
+    static std::shared_ptr<const SourceBuffer> FromAsset(const std::string &assetPath);
+    // Returns nullptr if the asset does not exist
+    static std::shared_ptr<const SourceBuffer> TryFromAsset(const std::string &assetPath);
+    // Reads the asset file itself, as binary data (i.e. not from the AssetPack).
+    // Returns nullptr if the asset does not exist
+    static std::shared_ptr<const SourceBuffer> TryFromAssetFile(const std::string &assetPath);
+    static std::shared_ptr<const SourceBuffer> FromBytes(std::unique_ptr<char[]> bytes, size_t size);
+
+    virtual ~SourceBuffer();
+    std::string_view view() const { return {mData, mSize}; }
+
+    struct Stats
+    {
+        int nbLiveBuffers = 0;
+        size_t nbLiveBytes = 0;
+        size_t nbMappedBytes = 0; // part of nbLiveBytes that is memory mapped
+    };
+    static Stats GetStats();
+
+protected:
+    SourceBuffer(const char *data, size_t size, bool isMapped);
+
+    const char *mData = nullptr;
+    size_t mSize = 0;
+    bool mIsMapped = false;
+};
@@ -0,0 +1,159 @@
+#include "SourceCache.h"
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace SourceCache
+{
+    namespace
+    {
+#ifdef __EMSCRIPTEN__
+        size_t gByteBudget = 32 * 1024 * 1024;
+#else
+        size_t gByteBudget = 64 * 1024 * 1024;
+#endif
+
+        struct CachedEditor
+        {
+            EditorKey key;
+            EditorSnapshot snapshot;
+            size_t nbBytes = 0;
+        };
+
+        struct Entry
+        {
+            Sources::Source source;
+            std::vector<CachedEditor> editors; // at most one per key
+            size_t editorBytes = 0;
+
+            size_t nbBytes() const { return source.sourceCode.size() + editorBytes; }
+        };
+
+        // Most recently used first
+        std::list<Entry> gEntries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> gEntryOfPath;
+        size_t gNbBytes = 0;
+        Stats gStats;
+
+        // A TextEditor stores one Glyph per character, in one vector per line
+        size_t EstimateEditorBytes(const Sources::Source &source, const TextEditor &editor)
+        {
+            return source.sourceCode.size() * sizeof(TextEditor::Glyph)
+                   + (size_t)editor.GetTotalLines() * sizeof(TextEditor::Line);
+        }
+
+        Entry *FindEntry(const std::string &sourcePath)
+        {
+            auto it = gEntryOfPath.find(sourcePath);
+            if (it == gEntryOfPath.end())
+                return nullptr;
+            gEntries.splice(gEntries.begin(), gEntries, it->second);
+            return &gEntries.front();
+        }
+
+        bool IsSameKey(const EditorKey &a, const EditorKey &b)
+        {
+            return a.windowName == b.windowName && a.isAnnotated == b.isAnnotated;
+        }
+
+        std::vector<CachedEditor>::iterator FindEditor(Entry &entry, const EditorKey &key)
+        {
+            return std::find_if(entry.editors.begin(), entry.editors.end(), [&key](const CachedEditor &editor) {
+                return IsSameKey(editor.key, key);
+            });
+        }
+
+        Entry *AddEntry(const Sources::Source &source)
+        {
+            gEntries.push_front({source, {}, 0});
+            gEntryOfPath[source.sourcePath] = gEntries.begin();
+            gNbBytes += gEntries.front().nbBytes();
+            return &gEntries.front();
+        }
+
+        void EvictIfNeeded()
+        {
+            while (gNbBytes > gByteBudget && !gEntries.empty())
+            {
+                gNbBytes -= gEntries.back().nbBytes();
+                gEntryOfPath.erase(gEntries.back().source.sourcePath);
+                gEntries.pop_back();
+            }
+        }
+    }
+
+    Sources::Source GetSource(const std::string &sourcePath)
+    {
+        if (Entry *entry = FindEntry(sourcePath))
+        {
+            ++gStats.nbSourceHits;
+            return entry->source;
+        }
+        ++gStats.nbSourceMisses;
+        Sources::Source source = Sources::ReadSource(sourcePath);
+        AddEntry(source);
+        EvictIfNeeded();
+        return source;
+    }
+
+    bool TakeEditorSnapshot(const std::string &sourcePath, const EditorKey &key, EditorSnapshot *snapshot)
+    {
+        Entry *entry = FindEntry(sourcePath);
+        if (entry != nullptr)
+        {
+            auto editor = FindEditor(*entry, key);
+            if (editor != entry->editors.end())
+            {
+                ++gStats.nbEditorHits;
+                gNbBytes -= editor->nbBytes;
+                entry->editorBytes -= editor->nbBytes;
+                *snapshot = std::move(editor->snapshot);
+                entry->editors.erase(editor);
+                return true;
+            }
+        }
+        ++gStats.nbEditorMisses;
+        return false;
+    }
+
+    void PutEditorSnapshot(const Sources::Source &source, const EditorKey &key, EditorSnapshot snapshot)
+    {
+        if (source.sourcePath.empty() || !snapshot.editor)
+            return;
+        Entry *entry = FindEntry(source.sourcePath);
+        if (entry == nullptr)
+            entry = AddEntry(source);
+        auto editor = FindEditor(*entry, key);
+        if (editor == entry->editors.end())
+            editor = entry->editors.insert(entry->editors.end(), {key, EditorSnapshot(), 0});
+        gNbBytes -= editor->nbBytes;
+        entry->editorBytes -= editor->nbBytes;
+        editor->nbBytes = EstimateEditorBytes(source, *snapshot.editor);
+        editor->snapshot = std::move(snapshot);
+        gNbBytes += editor->nbBytes;
+        entry->editorBytes += editor->nbBytes;
+        EvictIfNeeded();
+    }
+
+    void SetByteBudget(size_t nbBytes)
+    {
+        gByteBudget = nbBytes;
+        EvictIfNeeded();
+    }
+
+    size_t GetByteBudget()
+    {
+        return gByteBudget;
+    }
+
+    Stats GetStats()
+    {
+        Stats r = gStats;
+        r.nbSources = (int)gEntries.size();
+        for (const auto &entry : gEntries)
+            r.nbEditors += (int)entry.editors.size();
+        r.nbBytes = gNbBytes;
+        return r;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "EditorSnapshot.h"
+#include "Sources.h"
+#include <memory>
+#include <string>
+
+// SourceCache is a process wide LRU cache, shared by all the windows (e.g. the LibrariesCodeBrowser
+// of ImGuiCodeBrowser, AboutWindow and Acknowledgments). It keeps:
+// - the recently used sources
+// - the snapshots of their editors (already tokenized and colorized), which windows put back
+//   when they switch to another source, and take again when they come back to it.
+//   A snapshot is only given back to the window that put it (see EditorKey): windows never share
+//   an editor, with its breakpoints or the user's edits.
+// The cache stays within a byte budget, by evicting the least recently used sources.
+// It shall only be used from the ui thread.
+namespace SourceCache
+{
+    // Reads the source if it is not cached
+    Sources::Source GetSource(const std::string &sourcePath);
+
+    // Identifies who showed a source in an editor, and how
+    struct EditorKey
+    {
+        std::string windowName;   // e.g. "ImGuiCodeBrowser"
+        bool isAnnotated = false; // shown with the breakpoints of its tags
+    };
+
+    // Moves the cached editor snapshot of a source out of the cache, and returns true;
+    // returns false if there is none for this key
+    bool TakeEditorSnapshot(const std::string &sourcePath, const EditorKey &key, EditorSnapshot *snapshot);
+    // Puts the snapshot of an editor that displays source into the cache
+    void PutEditorSnapshot(const Sources::Source &source, const EditorKey &key, EditorSnapshot snapshot);
+
+    void SetByteBudget(size_t nbBytes);
+    size_t GetByteBudget();
+
+    struct Stats
+    {
+        int nbSources = 0;
+        int nbEditors = 0;
+        size_t nbBytes = 0; // sources + editors (estimated)
+        int nbSourceHits = 0;
+        int nbSourceMisses = 0;
+        int nbEditorHits = 0;
+        int nbEditorMisses = 0;
+    };
+    Stats GetStats();
+}
@@ -1,8 +1,7 @@
-#include "hello_imgui/hello_imgui_assets.h"
 #include <fplus/fplus.hpp>
 #include "Sources.h"
-
-using namespace std::literals;
+#include "AnnotationIndex.h"
+#include "TagScanner.h"
 
 namespace {
     auto make_string_vec = [](const std::string &s) -> std::vector<std::string> {
@@ -16,7 +15,6 @@ namespace {
 namespace Sources
 {
 
-
 std::vector<Library> imguiLibrary()
 {
     return
@@ -129,106 +127,23 @@ std::vector<Library> acknowldegmentLibraries()
 }
 
 
-std::string lowerCaseExceptFirstLetter(const std::string &s)
-{
-    auto r = fplus::to_upper_case(fplus::take(1, s)) +  fplus::to_lower_case(fplus::drop(1, s));
-    return r;
-}
-
-std::string upperCaseQAndA(const std::string &s)
-{
-    if (fplus::take(3, s) == "Q&a")
-        return "Q&A"s + fplus::drop(3, s);
-    else
-        return s;
-}
-
-std::string lowerCaseTitle(const std::string& s)
-{
-    auto words = fplus::split(' ', true, s);
-    words = fplus::transform(lowerCaseExceptFirstLetter, words);
-    auto title = fplus::join(" "s, words);
-    title = upperCaseQAndA(title);
-    return title;
-}
-
-LinesWithTags findImGuiCppDoc(const std::string &sourceCode)
+std::vector<std::string> librarySourcePaths(const std::vector<Library> &libraries)
 {
-    LinesWithTags r;
-    /*
-      H1 titles look like this
-      MISSION STATEMENT
-      =================
-      H2 titles look like this
-      READ FIRST
-     ----------
-   */
-    auto lines = fplus::split('\n', true, sourceCode);
-
-    // Given two lines, we can check whether they are a header
-    // and return 0 (not header) , 1 ("H1") or 2 ("H2")
-    auto isHeaderLine = [](const std::pair<std::string, std::string> &linePair) {
-        int r = 0;
-        if (fplus::is_prefix_of("===="s, fplus::trim_whitespace(linePair.second)))
-            r = 1;
-        if (fplus::is_prefix_of("----"s, fplus::trim_whitespace(linePair.second)))
-            r = 2;
-        return r;
-    };
-
-    for (auto idx_lines : fplus::enumerate(fplus::overlapping_pairs(lines)))
-    {
-        int lineNumber = (int)idx_lines.first + 1;
-        auto line_pair = idx_lines.second;
-        int headerWeight = isHeaderLine(line_pair);
-        std::string tag = fplus::trim_whitespace(line_pair.first);
-        tag = lowerCaseTitle(tag);
-        if (headerWeight == 1)
-            r.push_back({lineNumber, "H1 "s + tag});
-        if (headerWeight == 2)
-            r.push_back({lineNumber, "H2 "s + tag});
-    }
+    std::vector<std::string> r;
+    for (const auto &library : libraries)
+        for (const auto &sourcePath : library.sourcePaths)
+            r.push_back(library.path + "/" + sourcePath);
     return r;
 }
 
 
-LinesWithTags findImGuiDemoCodeLines(const std::string &sourceCode)
-{
-    LinesWithTags r;
-
-    static std::string regionToken = "DemoCode";
-
-    auto extractDemoCodeName = [](const std::string &codeLine) {
-        // if codeLine == "DemoCode("Line Plots")) {"
-        // then return
-        // "Line Plots"
-        auto tokens = fplus::split('"', true, codeLine);
-        if (tokens.size() >= 3)
-            return tokens[1];
-        else
-            return std::string();
-    };
-
-    auto lines = fplus::split('\n', true, sourceCode);
-    for (size_t line_number = 0; line_number < lines.size(); line_number++)
-    {
-        const std::string& line = lines[line_number];
-        if (line.find(regionToken) != std::string::npos)
-            r.push_back({(int)line_number + 1, extractDemoCodeName(line)});
-    }
-    return r;
-}
-
-Source ReadSource(const std::string sourcePath)
+Source ReadSource(const std::string& sourcePath)
 {
     std::string assetPath = std::string("code/") + sourcePath;
-    auto assetData = HelloImGui::LoadAssetFileData(assetPath.c_str());
-    assert(assetData.data != nullptr);
-
     Source r;
     r.sourcePath = sourcePath;
-    r.sourceCode = std::string((const char *) assetData.data);
-    HelloImGui::FreeAssetFileData(&assetData);
+    r.buffer = SourceBuffer::FromAsset(assetPath);
+    r.sourceCode = r.buffer->view();
     return r;
 }
 
@@ -237,14 +152,17 @@ AnnotatedSource ReadImGuiDemoCode(const std::string& sourcePath)
 {
     AnnotatedSource r;
     r.source = ReadSource(sourcePath);
-    r.linesWithTags = findImGuiDemoCodeLines(r.source.sourceCode);
+    auto makeLineWithTag = [](int lineNumber, std::string_view tag) { return MakeLineWithTag(lineNumber, tag); };
+    if (!LoadAnnotationIndex(r.source, makeLineWithTag, &r.linesWithTags))
+        r.linesWithTags = ScanImGuiDemoCodeTagsCached(r.source.sourceCode);
     return r;
 }
 
 AnnotatedSource ReadImGuiCppDoc(const std::string& sourcePath) {
     AnnotatedSource r;
     r.source = ReadSource(sourcePath);
-    r.linesWithTags = findImGuiCppDoc(r.source.sourceCode);
+    if (!LoadAnnotationIndex(r.source, MakeDocLineWithTag, &r.linesWithTags))
+        r.linesWithTags = ScanImGuiCppDocTagsCached(r.source.sourceCode);
     return r;
 }
 } // namespace Sources
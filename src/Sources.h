@@ -1,20 +1,37 @@
 #pragma once
+#include "SourceBuffer.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
+#include <memory>
 
 namespace Sources
 {
 struct Source
 {
     std::string sourcePath;
-    std::string sourceCode;
+    // sourceCode is a view inside buffer: copying a Source does not copy the code
+    std::string_view sourceCode;
+    std::shared_ptr<const SourceBuffer> buffer;
 };
 
+// The doc inside imgui.cpp has H1 / H2 titles; the tags of imgui_demo.cpp have no level
+enum class TagLevel
+{
+    None,
+    H1,
+    H2
+};
+
+// A tag and its outline entry, built once when the source is loaded
+// (so that the gui does not have to parse or format anything per frame)
 struct LineWithTag
 {
     int lineNumber;
-    std::string tag;
+    std::string tag; // the title, e.g. "Programmer Guide"
+    TagLevel level = TagLevel::None;
+    std::string label; // a unique ImGui label, e.g. "Programmer Guide##L123"
 };
 using LinesWithTags = std::vector<LineWithTag>;
 
@@ -38,9 +55,11 @@ std::vector<Library> helloImGuiLibrary();
 std::vector<Library> imguiManualLibrary();
 std::vector<Library> otherLibraries();
 std::vector<Library> acknowldegmentLibraries();
+// The paths of the sources of libraries, e.g. "imgui/imgui.h"
+std::vector<std::string> librarySourcePaths(const std::vector<Library> &libraries);
 
 
-Source ReadSource(const std::string sourcePath);
+Source ReadSource(const std::string& sourcePath);
 AnnotatedSource ReadImGuiDemoCode(const std::string& sourcePath);
 AnnotatedSource ReadImGuiCppDoc(const std::string& sourcePath);
 
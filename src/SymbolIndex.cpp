@@ -0,0 +1,146 @@
+#include "SymbolIndex.h"
+#include "Sources.h"
+#include "utilities/WorkerPool.h"
+#include <chrono>
+#include <memory>
+
+namespace SymbolIndex
+{
+    namespace
+    {
+        struct Data
+        {
+            SymbolTable table;
+            std::vector<std::string> sourcePaths; // by fileIndex
+            Sources::Source usagesSource;
+            Stats stats;
+        };
+
+        std::shared_ptr<const Data> gData;
+        std::vector<std::string> gSourcePaths; // set by SetSources
+        std::string gUsagesSourcePath;
+        bool gIsBuildStarted = false;
+
+        bool IsCppSource(const std::string &sourcePath)
+        {
+            size_t dot = sourcePath.rfind('.');
+            if (dot == std::string::npos)
+                return false;
+            std::string extension = sourcePath.substr(dot);
+            return extension == ".h" || extension == ".cpp";
+        }
+
+        Sources::Source ReadSource(const std::string &sourcePath)
+        {
+            Sources::Source r;
+            r.sourcePath = sourcePath;
+            r.buffer = SourceBuffer::TryFromAsset("code/" + sourcePath);
+            if (r.buffer)
+                r.sourceCode = r.buffer->view();
+            return r;
+        }
+
+        // Runs on a worker thread
+        void AddSource(Data &data, const std::string &sourcePath, const std::string &usagesSourcePath)
+        {
+            Sources::Source source = ReadSource(sourcePath);
+            data.table.addSource(source.sourceCode);
+            data.sourcePaths.push_back(sourcePath);
+            // Only the source of the usages is kept
+            if (sourcePath == usagesSourcePath)
+                data.usagesSource = source;
+        }
+
+        // Runs on a worker thread
+        void FinishData(Data &data, const std::string &usagesSourcePath)
+        {
+            data.table.sort();
+            if (!data.usagesSource.buffer)
+                data.usagesSource = ReadSource(usagesSourcePath);
+            data.stats.nbFiles = data.table.nbSources();
+            data.stats.nbSymbols = data.table.nbSymbols();
+            data.stats.nbBytes = data.table.memoryBytes();
+        }
+
+        // One job per source, so that each job stays short on single threaded emscripten builds.
+        // The jobs share data: each one is submitted when the previous one is done.
+        void SubmitBuildJob(std::shared_ptr<Data> data, size_t sourceIndex)
+        {
+            bool isLast = (sourceIndex == gSourcePaths.size());
+            std::string sourcePath = isLast ? "" : gSourcePaths[sourceIndex];
+            std::string usagesSourcePath = gUsagesSourcePath;
+            WorkerPool::Submit(
+                [data, sourcePath, usagesSourcePath, isLast] {
+                    auto start = std::chrono::steady_clock::now();
+                    if (isLast)
+                        FinishData(*data, usagesSourcePath);
+                    else
+                        AddSource(*data, sourcePath, usagesSourcePath);
+                    data->stats.buildDurationMs +=
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                },
+                [data, sourceIndex, isLast] {
+                    if (isLast)
+                        gData = data;
+                    else
+                        SubmitBuildJob(data, sourceIndex + 1);
+                });
+        }
+
+        void StartBuildIfNeeded()
+        {
+            if (gIsBuildStarted)
+                return;
+            gIsBuildStarted = true;
+            SubmitBuildJob(std::make_shared<Data>(), 0);
+        }
+    }
+
+    void SetSources(const std::vector<std::string> &sourcePaths, const std::string &usagesSourcePath)
+    {
+        gSourcePaths.clear();
+        for (const auto &sourcePath : sourcePaths)
+            if (IsCppSource(sourcePath))
+                gSourcePaths.push_back(sourcePath);
+        gUsagesSourcePath = usagesSourcePath;
+    }
+
+    bool IsReady()
+    {
+        return (bool)gData;
+    }
+
+    bool IsBuilding()
+    {
+        return gIsBuildStarted && !gData;
+    }
+
+    std::vector<Location> FindDefinitions(std::string_view name)
+    {
+        StartBuildIfNeeded();
+        std::vector<Location> r;
+        if (!gData)
+            return r;
+        for (const auto &location : gData->table.find(name))
+            r.push_back({gData->sourcePaths[location.fileIndex], location.lineNumber, location.kind, location.isDefinition});
+        return r;
+    }
+
+    std::vector<SymbolTable::Usage> FindUsages(std::string_view name)
+    {
+        StartBuildIfNeeded();
+        if (!gData)
+            return {};
+        return SymbolTable::FindUsages(gData->usagesSource.sourceCode, name);
+    }
+
+    const std::string &UsagesSourcePath()
+    {
+        return gUsagesSourcePath;
+    }
+
+    Stats GetStats()
+    {
+        return gData ? gData->stats : Stats();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "SymbolTable.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// SymbolIndex is the process wide index of the symbols of the ImGui sources (see SymbolTable),
+// used to go to the definition of a symbol from any WindowWithEditor,
+// and to list its usages in imgui_demo.cpp.
+// It is built in the background (see WorkerPool), starting at the first lookup: until then, lookups return nothing.
+// It shall only be used from the ui thread.
+namespace SymbolIndex
+{
+    struct Location
+    {
+        std::string sourcePath; // e.g. "imgui/imgui.h"
+        int lineNumber = 0;     // 0 based
+        SymbolTable::SymbolKind kind = SymbolTable::SymbolKind::Function;
+        bool isDefinition = false;
+    };
+
+    // Indexes the C++ sources (.h, .cpp) of sourcePaths; usages are searched in usagesSourcePath.
+    // Nothing is read until the first lookup.
+    void SetSources(const std::vector<std::string> &sourcePaths, const std::string &usagesSourcePath);
+    bool IsReady();
+    bool IsBuilding();
+
+    // The definitions first, then the declarations
+    std::vector<Location> FindDefinitions(std::string_view name);
+    // The lines of usagesSourcePath where name appears (their texts stay valid: the index is never freed)
+    std::vector<SymbolTable::Usage> FindUsages(std::string_view name);
+    const std::string &UsagesSourcePath();
+
+    struct Stats
+    {
+        int nbFiles = 0;
+        size_t nbSymbols = 0;
+        size_t nbBytes = 0; // of the symbol table
+        double buildDurationMs = 0.; // the sum of the build jobs
+    };
+    Stats GetStats();
+}
@@ -0,0 +1,874 @@
+#include "SymbolTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using SymbolKind = SymbolTable::SymbolKind;
+
+    bool IsIdentifierStart(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    bool IsIdentifierChar(char c)
+    {
+        return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+    }
+
+    // Keywords that may be followed by '(' or end a declaration, but never name a symbol
+    bool IsKeyword(std::string_view word)
+    {
+        static const char *keywords[] = {
+            "alignas", "alignof", "auto", "bool", "case", "catch", "char", "const", "decltype", "default",
+            "defined", "delete", "do", "double", "else", "float", "for", "if", "int", "long", "new", "noexcept",
+            "operator", "return", "short", "signed", "sizeof", "static_assert", "switch", "throw", "typeid",
+            "unsigned", "void", "while"};
+        for (const char *keyword : keywords)
+            if (word == keyword)
+                return true;
+        return false;
+    }
+
+    enum class TokenType
+    {
+        Identifier,
+        Number,
+        Punct, // one character, except "::" and "->"
+        End
+    };
+
+    struct Token
+    {
+        TokenType type = TokenType::End;
+        std::string_view text;
+        int lineNumber = 0;
+
+        bool is(char punct) const { return type == TokenType::Punct && text.size() == 1 && text[0] == punct; }
+        bool isIdentifier(const char *word) const { return type == TokenType::Identifier && text == word; }
+    };
+
+    struct FoundSymbol
+    {
+        std::string_view name;
+        int lineNumber;
+        SymbolKind kind;
+        bool isDefinition;
+    };
+
+    // Splits a source into tokens. Comments, string and character literals are skipped,
+    // and so are the preprocessor directives (the macros of #define are reported).
+    // Only the first branch of #if / #else chains is read, so that the braces stay balanced
+    // when each branch opens its own block.
+    class Lexer
+    {
+    public:
+        Lexer(std::string_view code, std::vector<FoundSymbol> *symbols) : mCode(code), mSymbols(symbols) {}
+
+        // A copy that reads ahead, without reporting the macros again
+        Lexer lookAhead() const
+        {
+            Lexer r = *this;
+            r.mSymbols = nullptr;
+            return r;
+        }
+
+        Token next()
+        {
+            while (mPos < mCode.size())
+            {
+                char c = mCode[mPos];
+                if (c == '\n')
+                {
+                    ++mLineNumber;
+                    ++mPos;
+                    mIsLineStart = true;
+                    continue;
+                }
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+                {
+                    ++mPos;
+                    continue;
+                }
+                if (c == '#' && mIsLineStart)
+                {
+                    readDirective();
+                    continue;
+                }
+                mIsLineStart = false;
+                char c2 = (mPos + 1 < mCode.size()) ? mCode[mPos + 1] : '\0';
+                if (c == '/' && c2 == '/')
+                {
+                    skipToLineEnd();
+                    continue;
+                }
+                if (c == '/' && c2 == '*')
+                {
+                    size_t end = mCode.find("*/", mPos + 2);
+                    end = (end == std::string_view::npos) ? mCode.size() : end + 2;
+                    skipTo(end);
+                    continue;
+                }
+                if (c == '"' || c == '\'')
+                {
+                    skipQuoted();
+                    continue;
+                }
+                Token token;
+                token.lineNumber = mLineNumber;
+                size_t start = mPos;
+                if (IsIdentifierStart(c))
+                {
+                    while (mPos < mCode.size() && IsIdentifierChar(mCode[mPos]))
+                        ++mPos;
+                    token.type = TokenType::Identifier;
+                    token.text = mCode.substr(start, mPos - start);
+                    if (mPos < mCode.size() && (mCode[mPos] == '"' || mCode[mPos] == '\'') && isLiteralPrefix(token.text))
+                    {
+                        if (token.text.back() == 'R' && mCode[mPos] == '"')
+                            skipRawString();
+                        else
+                            skipQuoted();
+                        continue;
+                    }
+                    return token;
+                }
+                if ((c >= '0' && c <= '9') || (c == '.' && c2 >= '0' && c2 <= '9'))
+                {
+                    while (mPos < mCode.size())
+                    {
+                        char d = mCode[mPos];
+                        bool isExponentSign = (d == '+' || d == '-')
+                            && strchr("eEpP", mCode[mPos - 1]) != nullptr;
+                        if (!IsIdentifierChar(d) && d != '.' && d != '\'' && !isExponentSign)
+                            break;
+                        ++mPos;
+                    }
+                    token.type = TokenType::Number;
+                    token.text = mCode.substr(start, mPos - start);
+                    return token;
+                }
+                bool isDouble = (c == ':' && c2 == ':') || (c == '-' && c2 == '>');
+                mPos += isDouble ? 2 : 1;
+                token.type = TokenType::Punct;
+                token.text = mCode.substr(start, mPos - start);
+                return token;
+            }
+            Token end;
+            end.lineNumber = mLineNumber;
+            return end;
+        }
+
+    private:
+        static bool isLiteralPrefix(std::string_view word)
+        {
+            for (const char *prefix : {"L", "u", "U", "u8", "R", "LR", "uR", "UR", "u8R"})
+                if (word == prefix)
+                    return true;
+            return false;
+        }
+
+        // Moves to end, counting the lines
+        void skipTo(size_t end)
+        {
+            mLineNumber += (int)std::count(mCode.begin() + (long)mPos, mCode.begin() + (long)end, '\n');
+            mPos = end;
+        }
+
+        // Stops before the '\n'
+        void skipToLineEnd()
+        {
+            size_t end = mCode.find('\n', mPos);
+            mPos = (end == std::string_view::npos) ? mCode.size() : end;
+        }
+
+        void skipQuoted()
+        {
+            char quote = mCode[mPos++];
+            while (mPos < mCode.size())
+            {
+                char c = mCode[mPos];
+                if (c == '\\' && mPos + 1 < mCode.size())
+                {
+                    if (mCode[mPos + 1] == '\n')
+                        ++mLineNumber;
+                    mPos += 2;
+                    continue;
+                }
+                if (c == '\n') // unterminated literal
+                    return;
+                ++mPos;
+                if (c == quote)
+                    return;
+            }
+        }
+
+        // R"delimiter( ... )delimiter"
+        void skipRawString()
+        {
+            size_t open = mCode.find('(', mPos);
+            if (open == std::string_view::npos)
+            {
+                skipTo(mCode.size());
+                return;
+            }
+            std::string closing = ")" + std::string(mCode.substr(mPos + 1, open - mPos - 1)) + "\"";
+            size_t end = mCode.find(closing, open);
+            skipTo((end == std::string_view::npos) ? mCode.size() : end + closing.size());
+        }
+
+        // The end of the logical line (with its '\' continuations), before the '\n'
+        size_t directiveEnd(size_t pos) const
+        {
+            while (true)
+            {
+                size_t end = mCode.find('\n', pos);
+                if (end == std::string_view::npos)
+                    return mCode.size();
+                size_t last = end;
+                if (last > pos && mCode[last - 1] == '\r')
+                    --last;
+                if (last == pos || mCode[last - 1] != '\\')
+                    return end;
+                pos = end + 1;
+            }
+        }
+
+        // mPos is on the '#': returns the directive name, and moves after it
+        std::string_view readDirectiveName()
+        {
+            ++mPos;
+            while (mPos < mCode.size() && (mCode[mPos] == ' ' || mCode[mPos] == '\t'))
+                ++mPos;
+            size_t start = mPos;
+            while (mPos < mCode.size() && IsIdentifierChar(mCode[mPos]))
+                ++mPos;
+            return mCode.substr(start, mPos - start);
+        }
+
+        void readDirective()
+        {
+            int lineNumber = mLineNumber;
+            std::string_view directive = readDirectiveName();
+            if (directive == "define")
+            {
+                while (mPos < mCode.size() && (mCode[mPos] == ' ' || mCode[mPos] == '\t'))
+                    ++mPos;
+                size_t start = mPos;
+                while (mPos < mCode.size() && IsIdentifierChar(mCode[mPos]))
+                    ++mPos;
+                if (mPos > start && mSymbols != nullptr)
+                    mSymbols->push_back({mCode.substr(start, mPos - start), lineNumber, SymbolKind::Macro, true});
+            }
+            skipTo(directiveEnd(mPos));
+            if (directive == "else" || directive == "elif")
+                skipConditionalBranch();
+        }
+
+        // Skips the lines up to the #endif that closes the current #if chain
+        void skipConditionalBranch()
+        {
+            int depth = 1;
+            while (mPos < mCode.size())
+            {
+                skipTo(std::min(mCode.size(), mPos + 1)); // the '\n' of the previous line
+                size_t lineStart = mPos;
+                while (mPos < mCode.size() && (mCode[mPos] == ' ' || mCode[mPos] == '\t'))
+                    ++mPos;
+                if (mPos < mCode.size() && mCode[mPos] == '#')
+                {
+                    std::string_view directive = readDirectiveName();
+                    if (directive == "if" || directive == "ifdef" || directive == "ifndef")
+                        ++depth;
+                    else if (directive == "endif")
+                        --depth;
+                }
+                else
+                    mPos = lineStart;
+                skipTo(directiveEnd(mPos));
+                if (depth == 0)
+                    return;
+            }
+        }
+
+        std::string_view mCode;
+        std::vector<FoundSymbol> *mSymbols;
+        size_t mPos = 0;
+        int mLineNumber = 0;
+        bool mIsLineStart = true;
+    };
+
+    // Reads the declarations of the namespace, class and enum scopes; function bodies are skipped
+    class Parser
+    {
+    public:
+        Parser(std::string_view code, std::vector<FoundSymbol> *symbols) : mLexer(code, symbols), mSymbols(symbols)
+        {
+            mScopes.push_back({ScopeKind::Namespace, {}});
+            advance();
+        }
+
+        void parse()
+        {
+            while (mToken.type != TokenType::End)
+                parseDeclaration();
+        }
+
+    private:
+        enum class ScopeKind
+        {
+            Namespace,
+            Class
+        };
+        struct Scope
+        {
+            ScopeKind kind;
+            std::string_view className;
+        };
+
+        // The state of the declaration being read
+        struct Declaration
+        {
+            int nbTokens = 0;
+            Token previous, beforePrevious;
+            Token lastIdentifier; // the last one outside of () and []
+            int lastIdentifierRank = -1;
+            bool hasParens = false;
+            bool isExtern = false;
+            bool hasFunction = false;
+            Token functionName;
+
+            void push(const Token &token)
+            {
+                beforePrevious = previous;
+                previous = token;
+                if (token.type == TokenType::Identifier && !IsKeyword(token.text))
+                {
+                    lastIdentifier = token;
+                    lastIdentifierRank = nbTokens;
+                }
+                ++nbTokens;
+            }
+            // Variables need a type before their name (e.g. "float x", "ImVec2 Pos")
+            bool hasVariableName() const { return lastIdentifierRank >= 1 && !hasParens; }
+        };
+
+        void advance() { mToken = mLexer.next(); }
+
+        Token peek() const
+        {
+            return mLexer.lookAhead().next();
+        }
+
+        void add(const Token &name, SymbolKind kind, bool isDefinition)
+        {
+            mSymbols->push_back({name.text, name.lineNumber, kind, isDefinition});
+        }
+
+        // mToken is on open: moves after the matching close
+        void skipBalanced(char open, char close)
+        {
+            int depth = 0;
+            do
+            {
+                if (mToken.is(open))
+                    ++depth;
+                else if (mToken.is(close))
+                    --depth;
+                advance();
+            } while (depth > 0 && mToken.type != TokenType::End);
+        }
+
+        void skipGroup()
+        {
+            if (mToken.is('('))
+                skipBalanced('(', ')');
+            else if (mToken.is('['))
+                skipBalanced('[', ']');
+            else if (mToken.is('{'))
+                skipBalanced('{', '}');
+            else
+                advance();
+        }
+
+        // Moves after the next ';' (or before the '}' that closes the scope)
+        void skipStatement()
+        {
+            while (mToken.type != TokenType::End && !mToken.is('}'))
+            {
+                if (mToken.is(';'))
+                {
+                    advance();
+                    return;
+                }
+                skipGroup();
+            }
+        }
+
+        // An initializer ("= value" or a bit field ": 3"): stops on the ',' or ';' that ends it
+        void skipInitializer()
+        {
+            while (mToken.type != TokenType::End && !mToken.is(',') && !mToken.is(';') && !mToken.is('}'))
+                skipGroup();
+        }
+
+        void parseDeclaration()
+        {
+            if (mToken.is('}'))
+            {
+                if (mScopes.size() > 1)
+                    mScopes.pop_back();
+                advance();
+                return;
+            }
+            if (mToken.is(';'))
+            {
+                advance();
+                return;
+            }
+            if (mToken.type == TokenType::Identifier)
+            {
+                std::string_view word = mToken.text;
+                if (word == "template")
+                {
+                    advance();
+                    if (mToken.is('<'))
+                        skipBalanced('<', '>');
+                    return;
+                }
+                if ((word == "public" || word == "private" || word == "protected") && peek().is(':'))
+                {
+                    advance();
+                    advance();
+                    return;
+                }
+                if (word == "namespace" || (word == "extern" && peek().is('{')))
+                {
+                    // namespace A::B {, or extern "C" { (the string is skipped by the lexer)
+                    while (mToken.type == TokenType::Identifier || mToken.text == "::")
+                        advance();
+                    if (mToken.is('{'))
+                    {
+                        mScopes.push_back({ScopeKind::Namespace, {}});
+                        advance();
+                    }
+                    else
+                        skipStatement();
+                    return;
+                }
+                if (word == "struct" || word == "class" || word == "union" || word == "enum")
+                {
+                    parseClassHead();
+                    return;
+                }
+                if (word == "typedef")
+                {
+                    parseTypedef();
+                    return;
+                }
+                if (word == "using")
+                {
+                    parseUsing();
+                    return;
+                }
+                if (word == "friend" || word == "static_assert")
+                {
+                    skipStatement();
+                    return;
+                }
+            }
+            Declaration declaration;
+            parseFunctionOrVariable(declaration);
+        }
+
+        // struct Name { ... }, enum Name : int { ... }, struct Name; or an elaborated type ("struct Name* p;")
+        void parseClassHead()
+        {
+            bool isEnum = mToken.isIdentifier("enum");
+            SymbolKind kind = isEnum ? SymbolKind::Enum : SymbolKind::Class;
+            Declaration declaration;
+            declaration.push(mToken);
+            advance();
+            // e.g. "struct IMGUI_API ImGuiWindow": the name is the last identifier
+            Token name;
+            while (mToken.type == TokenType::Identifier || mToken.text == "::")
+            {
+                if (mToken.type == TokenType::Identifier)
+                    name = mToken;
+                declaration.push(mToken);
+                advance();
+            }
+            if (mToken.is('<') && name.type != TokenType::End) // a template specialization
+                skipBalanced('<', '>');
+            if (name.type == TokenType::End)
+            {
+                // An unnamed struct or enum: only enum values may be found
+                if (mToken.is('{') && isEnum)
+                {
+                    advance();
+                    parseEnumBody();
+                }
+                else if (mToken.is('{'))
+                    skipBalanced('{', '}');
+                return;
+            }
+            if (mToken.is(';'))
+            {
+                add(name, kind, false);
+                advance();
+                return;
+            }
+            if (mToken.is(':')) // base classes, or the type of an enum
+            {
+                while (mToken.type != TokenType::End && !mToken.is('{') && !mToken.is(';'))
+                    advance();
+            }
+            if (mToken.is('{'))
+            {
+                add(name, kind, true);
+                advance();
+                if (isEnum)
+                    parseEnumBody();
+                else
+                    mScopes.push_back({ScopeKind::Class, name.text});
+                return;
+            }
+            parseFunctionOrVariable(declaration);
+        }
+
+        // After the '{': moves after the '}'
+        void parseEnumBody()
+        {
+            bool expectsName = true;
+            while (mToken.type != TokenType::End)
+            {
+                if (mToken.is('}'))
+                {
+                    advance();
+                    return;
+                }
+                if (expectsName && mToken.type == TokenType::Identifier)
+                {
+                    add(mToken, SymbolKind::Enumerator, true);
+                    expectsName = false;
+                    advance();
+                }
+                else if (mToken.is(','))
+                {
+                    expectsName = true;
+                    advance();
+                }
+                else
+                    skipGroup();
+            }
+        }
+
+        // typedef int ImGuiCol; typedef void (*ImDrawCallback)(...); typedef struct { ... } Name;
+        void parseTypedef()
+        {
+            advance();
+            if (mToken.isIdentifier("struct") || mToken.isIdentifier("union") || mToken.isIdentifier("enum"))
+            {
+                advance();
+                if (mToken.type == TokenType::Identifier)
+                    advance();
+                if (mToken.is('{'))
+                    skipBalanced('{', '}');
+            }
+            Token name, functionPointerName;
+            while (mToken.type != TokenType::End && !mToken.is(';') && !mToken.is('}'))
+            {
+                if (mToken.is('(') && functionPointerName.type == TokenType::End)
+                {
+                    // "(*Name)" or "(__stdcall *Name)"
+                    Lexer lexer = mLexer.lookAhead();
+                    Token previous = mToken;
+                    for (Token token = lexer.next(); token.type != TokenType::End && !token.is(')'); token = lexer.next())
+                    {
+                        if (token.type == TokenType::Identifier && previous.is('*'))
+                            functionPointerName = token;
+                        previous = token;
+                    }
+                    skipBalanced('(', ')');
+                    continue;
+                }
+                if (mToken.type == TokenType::Identifier && !IsKeyword(mToken.text))
+                    name = mToken;
+                skipGroup();
+            }
+            if (functionPointerName.type != TokenType::End)
+                name = functionPointerName;
+            if (name.type != TokenType::End)
+                add(name, SymbolKind::Typedef, true);
+            if (mToken.is(';'))
+                advance();
+        }
+
+        // using Name = Type;
+        void parseUsing()
+        {
+            advance();
+            if (mToken.type == TokenType::Identifier && peek().is('='))
+                add(mToken, SymbolKind::Typedef, true);
+            skipStatement();
+        }
+
+        // Reads a constructor initializer list, after the ':'. Returns true if it ends with the body '{'
+        bool skipInitializerList()
+        {
+            advance();
+            Token previous;
+            while (mToken.type != TokenType::End && !mToken.is(';'))
+            {
+                if (mToken.is('{'))
+                {
+                    // "member{value}" vs the body
+                    if (previous.type != TokenType::Identifier && !previous.is('>'))
+                        return true;
+                    skipBalanced('{', '}');
+                    previous = Token{TokenType::Punct, "}", 0};
+                    continue;
+                }
+                if (mToken.is('('))
+                {
+                    skipBalanced('(', ')');
+                    previous = Token{TokenType::Punct, ")", 0};
+                    continue;
+                }
+                previous = mToken;
+                advance();
+            }
+            return false;
+        }
+
+        bool isFunctionName(const Declaration &declaration) const
+        {
+            const Token &name = declaration.previous;
+            if (name.type != TokenType::Identifier || IsKeyword(name.text))
+                return false;
+            // A constructor declared inside its class: "ImVec2(float x, float y)"
+            if (declaration.nbTokens == 1)
+                return mScopes.back().kind == ScopeKind::Class && name.text == mScopes.back().className;
+            // Otherwise the name follows a type ("bool Begin(", "ImVec2* GetPos(", "bool ImGui::Begin(").
+            // A macro call at the start of a declaration ("IM_STATIC_ASSERT(") has no type,
+            // and a destructor ("~ImVector(") is not indexed.
+            const Token &before = declaration.beforePrevious;
+            return before.type == TokenType::Identifier || before.is('*') || before.is('&') || before.is('>')
+                   || before.text == "::";
+        }
+
+        void parseFunctionOrVariable(Declaration &declaration)
+        {
+            bool isClassScope = (mScopes.back().kind == ScopeKind::Class);
+            while (mToken.type != TokenType::End)
+            {
+                if (mToken.is('}'))
+                    return; // a declaration without ';' (e.g. a macro): the '}' closes the scope
+                if (mToken.is(';'))
+                {
+                    if (declaration.hasFunction)
+                        add(declaration.functionName, SymbolKind::Function, false);
+                    else if (declaration.hasVariableName())
+                        add(declaration.lastIdentifier, SymbolKind::Variable, !declaration.isExtern);
+                    advance();
+                    return;
+                }
+                if (mToken.is(','))
+                {
+                    // "float x, y;"
+                    if (declaration.hasVariableName())
+                        add(declaration.lastIdentifier, SymbolKind::Variable, !declaration.isExtern);
+                    advance();
+                    continue;
+                }
+                if (mToken.is('=') || (mToken.is(':') && isClassScope && !declaration.hasFunction))
+                {
+                    if (declaration.hasFunction)
+                    {
+                        // "= 0", "= default", "= delete"
+                        add(declaration.functionName, SymbolKind::Function, false);
+                        skipStatement();
+                        return;
+                    }
+                    // "int x = 3" or the bit field "unsigned int Codepoint : 31"
+                    if (declaration.hasVariableName())
+                        add(declaration.lastIdentifier, SymbolKind::Variable, !declaration.isExtern);
+                    advance();
+                    skipInitializer();
+                    declaration.lastIdentifierRank = -1;
+                    continue;
+                }
+                if (mToken.is(':') && declaration.hasFunction)
+                {
+                    bool hasBody = skipInitializerList();
+                    add(declaration.functionName, SymbolKind::Function, hasBody);
+                    if (hasBody)
+                        skipBalanced('{', '}');
+                    return;
+                }
+                if (mToken.is('('))
+                {
+                    if (!declaration.hasFunction && !declaration.hasParens && isFunctionName(declaration))
+                    {
+                        declaration.hasFunction = true;
+                        declaration.functionName = declaration.previous;
+                    }
+                    declaration.hasParens = true;
+                    skipBalanced('(', ')');
+                    declaration.push(Token{TokenType::Punct, ")", 0});
+                    continue;
+                }
+                if (mToken.is('{'))
+                {
+                    if (declaration.hasFunction)
+                        add(declaration.functionName, SymbolKind::Function, true);
+                    else if (declaration.hasVariableName())
+                        add(declaration.lastIdentifier, SymbolKind::Variable, true); // "ImVec2 Pos{0, 0}"
+                    skipBalanced('{', '}');
+                    if (declaration.hasParens)
+                        return; // a function body, which is not followed by ';'
+                    declaration.lastIdentifierRank = -1;
+                    continue;
+                }
+                if (mToken.is('['))
+                {
+                    skipBalanced('[', ']');
+                    declaration.push(Token{TokenType::Punct, "]", 0});
+                    continue;
+                }
+                if (mToken.is('<') && declaration.previous.type == TokenType::Identifier
+                    && !IsKeyword(declaration.previous.text))
+                {
+                    // Template arguments: "ImVector<ImGuiWindow*> Windows"
+                    skipBalanced('<', '>');
+                    declaration.push(Token{TokenType::Punct, ">", 0});
+                    continue;
+                }
+                if (mToken.isIdentifier("operator"))
+                {
+                    // "operator[]", "operator()", "operator ImVec4": the symbol is not indexed
+                    advance();
+                    if (mToken.is('('))
+                    {
+                        advance();
+                        advance();
+                    }
+                    while (mToken.type != TokenType::End && !mToken.is('(') && !mToken.is(';'))
+                        advance();
+                    declaration.push(Token{TokenType::Punct, "operator", 0});
+                    continue;
+                }
+                if (mToken.isIdentifier("extern"))
+                    declaration.isExtern = true;
+                declaration.push(mToken);
+                advance();
+            }
+        }
+
+        Lexer mLexer;
+        std::vector<FoundSymbol> *mSymbols;
+        Token mToken;
+        std::vector<Scope> mScopes;
+    };
+}
+
+void SymbolTable::addSource(std::string_view code)
+{
+    std::vector<FoundSymbol> symbols;
+    Parser(code, &symbols).parse();
+
+    uint16_t fileIndex = (uint16_t)mNbSources++;
+    mEntries.reserve(mEntries.size() + symbols.size());
+    for (const auto &symbol : symbols)
+    {
+        std::string name(symbol.name);
+        auto it = mNameOffsets.find(name);
+        if (it == mNameOffsets.end())
+        {
+            it = mNameOffsets.emplace(name, (uint32_t)mNames.size()).first;
+            mNames += name;
+        }
+        Entry entry;
+        entry.nameOffset = it->second;
+        entry.lineNumber = (uint32_t)symbol.lineNumber;
+        entry.nameSize = (uint16_t)name.size();
+        entry.fileIndex = fileIndex;
+        entry.kind = symbol.kind;
+        entry.isDefinition = symbol.isDefinition;
+        mEntries.push_back(entry);
+    }
+}
+
+void SymbolTable::sort()
+{
+    std::sort(mEntries.begin(), mEntries.end(), [this](const Entry &a, const Entry &b) {
+        std::string_view nameA = nameOf(a), nameB = nameOf(b);
+        if (nameA != nameB)
+            return nameA < nameB;
+        if (a.isDefinition != b.isDefinition)
+            return a.isDefinition;
+        if (a.fileIndex != b.fileIndex)
+            return a.fileIndex < b.fileIndex;
+        return a.lineNumber < b.lineNumber;
+    });
+    mEntries.shrink_to_fit();
+    mNames.shrink_to_fit();
+    mNameOffsets = {};
+}
+
+std::vector<SymbolTable::Location> SymbolTable::find(std::string_view name) const
+{
+    auto first = std::lower_bound(mEntries.begin(), mEntries.end(), name,
+                                  [this](const Entry &entry, std::string_view n) { return nameOf(entry) < n; });
+    std::vector<Location> r;
+    for (auto it = first; it != mEntries.end() && nameOf(*it) == name; ++it)
+        r.push_back({(int)it->fileIndex, (int)it->lineNumber, it->kind, it->isDefinition});
+    return r;
+}
+
+size_t SymbolTable::memoryBytes() const
+{
+    return mEntries.capacity() * sizeof(Entry) + mNames.capacity();
+}
+
+const char *SymbolTable::KindName(SymbolKind kind)
+{
+    switch (kind)
+    {
+        case SymbolKind::Macro: return "macro";
+        case SymbolKind::Class: return "struct";
+        case SymbolKind::Enum: return "enum";
+        case SymbolKind::Enumerator: return "enum value";
+        case SymbolKind::Typedef: return "typedef";
+        case SymbolKind::Function: return "function";
+        case SymbolKind::Variable: return "variable";
+    }
+    return "";
+}
+
+std::vector<SymbolTable::Usage> SymbolTable::FindUsages(std::string_view code, std::string_view name)
+{
+    std::vector<Usage> usages;
+    if (name.empty())
+        return usages;
+    int lineNumber = 0;
+    size_t lineCountedUpTo = 0;
+    for (size_t pos = code.find(name); pos != std::string_view::npos; pos = code.find(name, pos + name.size()))
+    {
+        size_t end = pos + name.size();
+        if ((pos > 0 && IsIdentifierChar(code[pos - 1])) || (end < code.size() && IsIdentifierChar(code[end])))
+            continue;
+        lineNumber += (int)std::count(code.begin() + (long)lineCountedUpTo, code.begin() + (long)pos, '\n');
+        lineCountedUpTo = pos;
+        if (!usages.empty() && usages.back().lineNumber == lineNumber)
+            continue;
+        size_t lineStart = code.rfind('\n', pos);
+        lineStart = (lineStart == std::string_view::npos) ? 0 : lineStart + 1;
+        size_t lineEnd = code.find('\n', pos);
+        lineEnd = (lineEnd == std::string_view::npos) ? code.size() : lineEnd;
+        while (lineEnd > lineStart && code[lineEnd - 1] == '\r')
+            --lineEnd;
+        usages.push_back({lineNumber, code.substr(lineStart, lineEnd - lineStart)});
+    }
+    return usages;
+}
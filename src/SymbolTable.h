@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// SymbolTable lists the symbols declared or defined by some C++ sources
+// (functions, structs, enums and their values, typedefs, variables and members, macros).
+//
+// The sources are scanned by a light C++ parser: it follows the namespace / class / enum scopes,
+// skips the function bodies, and only reads the first branch of #if / #else chains.
+// It is tuned for the style of Dear ImGui, and is not a complete C++ parser.
+//
+// The table is compact: one 16 bytes entry per symbol, sorted by name, whose names
+// are offsets into a single string. A lookup is a binary search.
+class SymbolTable
+{
+public:
+    enum class SymbolKind : uint8_t
+    {
+        Macro,
+        Class,      // struct, class or union
+        Enum,
+        Enumerator,
+        Typedef,    // or using
+        Function,
+        Variable    // or member
+    };
+    struct Location
+    {
+        int fileIndex = 0;
+        int lineNumber = 0; // 0 based
+        SymbolKind kind = SymbolKind::Function;
+        bool isDefinition = false;
+    };
+
+    // Scans a C++ source: its symbols are at fileIndex == the number of sources added before it
+    void addSource(std::string_view code);
+    // Call this once all the sources were added (find() needs a sorted table)
+    void sort();
+
+    // Returns the definitions first, then the declarations, each in file then line order
+    std::vector<Location> find(std::string_view name) const;
+
+    int nbSources() const { return mNbSources; }
+    size_t nbSymbols() const { return mEntries.size(); }
+    size_t memoryBytes() const;
+
+    static const char *KindName(SymbolKind kind);
+
+    struct Usage
+    {
+        int lineNumber = 0;        // 0 based
+        std::string_view lineText; // a view inside the searched code
+    };
+    // The lines where name appears as a whole identifier (comments and strings included)
+    static std::vector<Usage> FindUsages(std::string_view code, std::string_view name);
+
+private:
+    struct Entry
+    {
+        uint32_t nameOffset;
+        uint32_t lineNumber;
+        uint16_t nameSize;
+        uint16_t fileIndex;
+        SymbolKind kind;
+        bool isDefinition;
+    };
+    std::string_view nameOf(const Entry &entry) const { return {mNames.data() + entry.nameOffset, entry.nameSize}; }
+
+    std::string mNames;
+    std::vector<Entry> mEntries;
+    std::unordered_map<std::string, uint32_t> mNameOffsets; // only used while sources are added
+    int mNbSources = 0;
+};
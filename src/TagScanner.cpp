@@ -0,0 +1,224 @@
+#include "TagScanner.h"
+#include "utilities/ArtifactCache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Sources
+{
+namespace
+{
+    bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    std::string_view trimWhitespace(std::string_view s)
+    {
+        while (!s.empty() && isWhitespace(s.front()))
+            s.remove_prefix(1);
+        while (!s.empty() && isWhitespace(s.back()))
+            s.remove_suffix(1);
+        return s;
+    }
+
+    bool startsWith(std::string_view s, std::string_view prefix)
+    {
+        return s.substr(0, prefix.size()) == prefix;
+    }
+
+    char toUpper(char c) { return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c; }
+    char toLower(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; }
+
+    // "MISSION STATEMENT" -> "Mission Statement", "Q&A" stays "Q&A"
+    std::string titleCase(std::string_view s)
+    {
+        std::string r(s);
+        for (size_t i = 0; i < r.size(); ++i)
+        {
+            bool isWordStart = (i == 0) || (r[i - 1] == ' ');
+            r[i] = isWordStart ? toUpper(r[i]) : toLower(r[i]);
+        }
+        if (startsWith(r, "Q&a"))
+            r[2] = 'A';
+        return r;
+    }
+
+    // Calls fn(line, lineIndex) for each line (without its '\n').
+    // As with fplus::split('\n', true, ...), a trailing '\n' is followed by an empty last line.
+    template <typename Fn>
+    void forEachLine(std::string_view code, Fn fn)
+    {
+        const char *lineStart = code.data();
+        const char *end = code.data() + code.size();
+        int lineIndex = 0;
+        while (true)
+        {
+            const char *lineEnd = (const char *)memchr(lineStart, '\n', (size_t)(end - lineStart));
+            if (lineEnd == nullptr)
+            {
+                fn(std::string_view(lineStart, (size_t)(end - lineStart)), lineIndex);
+                return;
+            }
+            fn(std::string_view(lineStart, (size_t)(lineEnd - lineStart)), lineIndex);
+            lineStart = lineEnd + 1;
+            ++lineIndex;
+        }
+    }
+} // namespace
+
+
+LineWithTag MakeLineWithTag(int lineNumber, std::string_view tag, TagLevel level)
+{
+    LineWithTag r;
+    r.lineNumber = lineNumber;
+    r.tag = std::string(tag);
+    r.level = level;
+    r.label = r.tag + "##L" + std::to_string(lineNumber);
+    return r;
+}
+
+LineWithTag MakeDocLineWithTag(int lineNumber, std::string_view prefixedTag)
+{
+    TagLevel level = TagLevel::None;
+    if (prefixedTag.substr(0, 3) == "H1 ")
+        level = TagLevel::H1;
+    else if (prefixedTag.substr(0, 3) == "H2 ")
+        level = TagLevel::H2;
+    if (level != TagLevel::None)
+        prefixedTag.remove_prefix(3);
+    return MakeLineWithTag(lineNumber, prefixedTag, level);
+}
+
+LinesWithTags ScanImGuiCppDocTags(std::string_view sourceCode)
+{
+    /*
+      H1 titles look like this
+      MISSION STATEMENT
+      =================
+      H2 titles look like this
+      READ FIRST
+     ----------
+    */
+    LinesWithTags r;
+    std::string_view previousLine;
+    forEachLine(sourceCode, [&](std::string_view line, int lineIndex) {
+        if (lineIndex > 0)
+        {
+            // Only a left trim is needed to test the underline prefix
+            std::string_view underline = line;
+            while (!underline.empty() && isWhitespace(underline.front()))
+                underline.remove_prefix(1);
+            TagLevel level = TagLevel::None;
+            if (startsWith(underline, "===="))
+                level = TagLevel::H1;
+            else if (startsWith(underline, "----"))
+                level = TagLevel::H2;
+            // The title is on the previous line, whose number (1 based) is lineIndex
+            if (level != TagLevel::None)
+                r.push_back(MakeLineWithTag(lineIndex, titleCase(trimWhitespace(previousLine)), level));
+        }
+        previousLine = line;
+    });
+    return r;
+}
+
+LinesWithTags ScanImGuiDemoCodeTags(std::string_view sourceCode)
+{
+    static constexpr std::string_view regionToken = "DemoCode";
+
+    LinesWithTags r;
+    size_t countedUpTo = 0; // newlines are counted up to this position
+    int lineIndex = 0;
+    size_t tokenPos = sourceCode.find(regionToken);
+    while (tokenPos != std::string_view::npos)
+    {
+        size_t lineStart = sourceCode.rfind('\n', tokenPos);
+        lineStart = (lineStart == std::string_view::npos) ? 0 : lineStart + 1;
+        size_t lineEnd = sourceCode.find('\n', tokenPos);
+        if (lineEnd == std::string_view::npos)
+            lineEnd = sourceCode.size();
+
+        lineIndex += (int)std::count(sourceCode.begin() + countedUpTo, sourceCode.begin() + lineStart, '\n');
+        countedUpTo = lineStart;
+
+        // if the line is
+        //     DemoCode("Line Plots")) {
+        // then the tag is
+        //     Line Plots
+        std::string_view line = sourceCode.substr(lineStart, lineEnd - lineStart);
+        std::string tag;
+        size_t quote1 = line.find('"');
+        if (quote1 != std::string_view::npos)
+        {
+            size_t quote2 = line.find('"', quote1 + 1);
+            if (quote2 != std::string_view::npos)
+                tag = std::string(line.substr(quote1 + 1, quote2 - quote1 - 1));
+        }
+        r.push_back(MakeLineWithTag(lineIndex + 1, tag));
+
+        if (lineEnd == sourceCode.size())
+            break;
+        tokenPos = sourceCode.find(regionToken, lineEnd + 1);
+    }
+    return r;
+}
+
+namespace
+{
+    // Bump this when the scanners, or the payload, change.
+    // Payload: varuint nbTags, then for each tag: varuint lineNumber, u8 level, string tag
+    constexpr uint32_t kTagsFormatVersion = 1;
+
+    bool DecodeTags(std::string_view payload, LinesWithTags *linesWithTags)
+    {
+        ArtifactCache::Reader reader(payload);
+        uint32_t nbTags;
+        if (!reader.readVarUint(&nbTags) || nbTags > payload.size())
+            return false;
+        linesWithTags->reserve(nbTags);
+        for (uint32_t i = 0; i < nbTags; ++i)
+        {
+            uint32_t lineNumber;
+            uint8_t level;
+            std::string_view tag;
+            if (!reader.readVarUint(&lineNumber) || !reader.read(&level) || !reader.readString(&tag)
+                || level > (uint8_t)TagLevel::H2)
+                return false;
+            linesWithTags->push_back(MakeLineWithTag((int)lineNumber, tag, (TagLevel)level));
+        }
+        return reader.isAtEnd();
+    }
+
+    LinesWithTags ScanTagsCached(std::string_view kind, std::string_view sourceCode,
+                                 LinesWithTags (*scanTags)(std::string_view))
+    {
+        auto key = ArtifactCache::MakeKey(kind, kTagsFormatVersion, sourceCode);
+        std::string payload;
+        LinesWithTags r;
+        if (ArtifactCache::Load(key, &payload) && DecodeTags(payload, &r))
+            return r;
+
+        r = scanTags(sourceCode);
+        ArtifactCache::Writer writer;
+        writer.writeVarUint((uint32_t)r.size());
+        for (const auto &lineWithTag : r)
+        {
+            writer.writeVarUint((uint32_t)lineWithTag.lineNumber);
+            writer.write((uint8_t)lineWithTag.level);
+            writer.writeString(lineWithTag.tag);
+        }
+        ArtifactCache::Store(key, writer.bytes());
+        return r;
+    }
+} // namespace
+
+LinesWithTags ScanImGuiCppDocTagsCached(std::string_view sourceCode)
+{
+    return ScanTagsCached("cpp_doc_tags", sourceCode, ScanImGuiCppDocTags);
+}
+
+LinesWithTags ScanImGuiDemoCodeTagsCached(std::string_view sourceCode)
+{
+    return ScanTagsCached("demo_code_tags", sourceCode, ScanImGuiDemoCodeTags);
+}
+} // namespace Sources
@@ -0,0 +1,24 @@
+#pragma once
+#include "Sources.h"
+#include <string_view>
+
+// Single pass scanners that find the tags inside a source buffer.
+// They do not allocate per line: strings are only built for the tags they find.
+namespace Sources
+{
+// Builds a tag entry, with its ImGui label (see LineWithTag)
+LineWithTag MakeLineWithTag(int lineNumber, std::string_view tag, TagLevel level = TagLevel::None);
+// Doc tags are stored as "H1 Title" or "H2 Title" in annotation indexes (see make_annotation_index.sh)
+LineWithTag MakeDocLineWithTag(int lineNumber, std::string_view prefixedTag);
+
+// Finds the H1 / H2 titles of the doc inside imgui.cpp
+LinesWithTags ScanImGuiCppDocTags(std::string_view sourceCode);
+
+// Finds the DemoCode("...") markers inside imgui_demo.cpp
+LinesWithTags ScanImGuiDemoCodeTags(std::string_view sourceCode);
+
+// Same as above, through the ArtifactCache: the tags of a source that was scanned
+// during a previous launch are read back instead
+LinesWithTags ScanImGuiCppDocTagsCached(std::string_view sourceCode);
+LinesWithTags ScanImGuiDemoCodeTagsCached(std::string_view sourceCode);
+} // namespace Sources
@@ -1,91 +1,267 @@
 #include "hello_imgui.h"
-#include <fplus/fplus.hpp>
+#include "utilities/FrameArena.h"
 #include "utilities/ImGuiExt.h"
+#include "utilities/Profiler.h"
+#include "utilities/WorkerPool.h"
+#include "CodeNavigation.h"
+#include "SourceCache.h"
 #include "WindowWithEditor.h"
+#include "imgui_internal.h"
+#include <chrono>
+#include <cstdio>
 
-std::vector<TextEditor *> gAllEditors;
+// Editors may be built (or taken from SourceCache) after the user selected a palette:
+// it is applied when they are rendered
+TextEditor::Palette gEditorPalette = TextEditor::GetLightPalette();
 
-WindowWithEditor::WindowWithEditor()
+WindowWithEditor::WindowWithEditor(std::string windowName)
+    : mWindowName(std::move(windowName))
 {
-    mEditor.SetPalette(TextEditor::GetLightPalette());
-    mEditor.SetLanguageDefinition(TextEditor::LanguageDefinition::CPlusPlus());
-    mEditor.SetReadOnly(true);
-    gAllEditors.push_back(&mEditor);
+}
+
+WindowWithEditor::~WindowWithEditor()
+{
+    // Windows may be freed when hidden (see LazyWindowRegistry): they will find their editor back
+    putEditorSnapshotIntoCache();
+}
+
+void WindowWithEditor::putEditorSnapshotIntoCache()
+{
+    // Large sources are shown without an editor
+    if (!mEditorSource.sourcePath.empty() && !mLargeFileView && mEditor)
+        SourceCache::PutEditorSnapshot(mEditorSource, editorKey(), saveEditorSnapshot());
+}
+
+std::shared_ptr<TextEditor> WindowWithEditor::MakeEditor()
+{
+    auto editor = std::make_shared<TextEditor>();
+    editor->SetPalette(gEditorPalette);
+    editor->SetLanguageDefinition(EditorColorizer::LanguageDefinition());
+    editor->SetReadOnly(true);
+    return editor;
+}
+
+void WindowWithEditor::ensureEditor()
+{
+    if (mEditor)
+        return;
+    mEditor = MakeEditor();
+    mColorizer = std::make_shared<EditorColorizer>();
+}
+
+EditorSnapshot WindowWithEditor::saveEditorSnapshot()
+{
+    // The window makes a new editor only if it shows a source again (e.g. not when it is freed)
+    EditorSnapshot snapshot{std::move(mEditor), std::move(mColorizer), mEditorScrollY};
+    mEditorScrollY = 0.f;
+    mSearch.onTextReplaced();
+    return snapshot;
+}
+
+void WindowWithEditor::restoreEditorSnapshot(EditorSnapshot snapshot)
+{
+    mLargeFileView.reset();
+    mEditor = std::move(snapshot.editor);
+    mColorizer = snapshot.colorizer ? std::move(snapshot.colorizer) : std::make_shared<EditorColorizer>();
+    mPendingEditorScrollY = snapshot.scrollY;
+    mSearch.onTextReplaced();
+}
+
+void WindowWithEditor::setEditorSource(const Sources::Source &source, bool isAnnotated)
+{
+    putEditorSnapshotIntoCache();
+    mEditorSource = source;
+    mIsEditorSourceAnnotated = isAnnotated;
+    if (LargeFileView::IsLargeSource(source.sourceCode))
+    {
+        // The editor stays empty
+        mLargeFileView = std::make_unique<LargeFileView>();
+        mLargeFileView->setSource(source);
+        mSearch.onTextReplaced();
+        return;
+    }
+    EditorSnapshot snapshot;
+    if (SourceCache::TakeEditorSnapshot(source.sourcePath, editorKey(), &snapshot))
+        restoreEditorSnapshot(std::move(snapshot));
+    else
+        setEditorText(source.sourceCode);
+}
+
+void WindowWithEditor::setEditorText(std::string_view text)
+{
+    mLargeFileView.reset();
+    ensureEditor();
+    mEditor->SetText(std::string(text));
+    mColorizer->onTextReplaced(text);
+    mSearch.onTextReplaced();
 }
 
 void WindowWithEditor::setEditorAnnotatedSource(const Sources::AnnotatedSource &annotatedSource)
 {
-    mEditor.SetText(annotatedSource.source.sourceCode);
+    setEditorSource(annotatedSource.source, true);
+    // Also when the editor was restored: the tags are those of this source
     std::unordered_set<int> lineNumbers;
     for (auto line : annotatedSource.linesWithTags)
         lineNumbers.insert(line.lineNumber);
-    mEditor.SetBreakpoints(lineNumbers);
+    if (mLargeFileView)
+        mLargeFileView->setBreakpoints(lineNumbers);
+    else
+        mEditor->SetBreakpoints(lineNumbers);
 }
-void WindowWithEditor::RenderEditor(const std::string &filename, VoidFunction additionalGui)
+
+int WindowWithEditor::cursorLine() const
 {
+    if (mLargeFileView)
+        return mLargeFileView->cursorLine();
+    return mEditor ? mEditor->GetCursorPosition().mLine : 0;
+}
+
+void WindowWithEditor::setCursorLine(int lineNumber, int cursorLineOnPage)
+{
+    if (mLargeFileView)
+        mLargeFileView->setCursorLine(lineNumber, cursorLineOnPage);
+    else if (mEditor)
+        mEditor->SetCursorPosition({lineNumber, 0}, cursorLineOnPage);
+}
+
+void WindowWithEditor::setSearchFilter(const std::string &filterText)
+{
+    snprintf(mFilter.InputBuf, sizeof(mFilter.InputBuf), "%s", filterText.c_str());
+    mFilter.Build();
+}
+
+void WindowWithEditor::setEditorAnnotatedSourceAsync(
+    std::function<Sources::AnnotatedSource(void)> loader,
+    std::function<void(Sources::AnnotatedSource &)> onLoaded)
+{
+    mIsLoading = true;
+    auto result = std::make_shared<Sources::AnnotatedSource>();
+    std::weak_ptr<bool> aliveToken = mAliveToken;
+    WorkerPool::Submit(
+        [result, loader] { *result = loader(); },
+        [this, result, aliveToken, onLoaded] {
+            if (aliveToken.expired())
+                return;
+            setEditorAnnotatedSource(*result);
+            mIsLoading = false;
+            if (onLoaded)
+                onLoaded(*result);
+        });
+}
+
+void WindowWithEditor::RenderEditor(const char *filename, VoidFunction additionalGui)
+{
+    Profiler::ScopedTimer scopedTimer("WindowWithEditor::RenderEditor");
+    if (mIsLoading)
+    {
+        ImGui::TextDisabled("Loading %s...", filename);
+        return;
+    }
+    if (!mLargeFileView)
+        ensureEditor();
+    CodeNavigation::Request request;
+    if (CodeNavigation::TakeRequestForCurrentWindow(&request))
+        setCursorLine(request.lineNumber, 3);
     guiIconBar(additionalGui);
     guiStatusLine(filename);
-    mEditor.Render(filename.c_str());
+    guiSymbolPopup();
+    if (mLargeFileView)
+    {
+        mLargeFileView->render(filename, gEditorPalette);
+        return;
+    }
+    if (mEditor->GetPalette() != gEditorPalette)
+        mEditor->SetPalette(gEditorPalette);
+    {
+        // The lines that will be visible are colorized first (see EditorColorizer)
+        float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        float scrollY = (mPendingEditorScrollY >= 0.f) ? mPendingEditorScrollY : mEditorScrollY;
+        int firstVisibleLine = (int)(scrollY / lineHeight);
+        int nbVisibleLines = (int)(ImGui::GetContentRegionAvail().y / lineHeight) + 2;
+        mColorizer->beginRender(*mEditor, firstVisibleLine, nbVisibleLines);
+        mEditor->Render(filename);
+        mColorizer->endRender();
+    }
+
+    // Remember (or restore) the scroll position of the editor child window
+    ImGuiWindow *editorWindow = findEditorChildWindow(filename);
+    if (editorWindow != nullptr)
+    {
+        if (mPendingEditorScrollY >= 0.f)
+        {
+            ImGui::SetScrollY(editorWindow, mPendingEditorScrollY);
+            mPendingEditorScrollY = -1.f;
+        }
+        else
+            mEditorScrollY = editorWindow->Scroll.y;
+
+        // The editor moved its cursor to the click
+        const ImGuiIO &io = ImGui::GetIO();
+        if (ImGui::GetCurrentContext()->HoveredWindow == editorWindow && io.KeyCtrl && ImGui::IsMouseClicked(0))
+        {
+            if (io.KeyShift)
+                openSymbolPopup(wordUnderCursor());
+            else
+                goToDefinition(wordUnderCursor());
+        }
+    }
+    if (mEditor->IsTextChanged())
+        mSearch.onTextEdited();
 }
 
-void WindowWithEditor::guiStatusLine(const std::string &filename)
+ImGuiWindow *WindowWithEditor::findEditorChildWindow(const char *filename) const
 {
-    auto & editor = mEditor;
+    // TextEditor::Render(filename) calls BeginChild(filename): this is the name BeginChildEx() gives the child
+    ImGuiWindow *window = ImGui::GetCurrentWindow();
+    return ImGui::FindWindowByName(
+        FrameArena::Format("%s/%s_%08X", window->Name, filename, ImGui::GetID(filename)));
+}
+
+void WindowWithEditor::guiStatusLine(const char *filename)
+{
+    if (mLargeFileView)
+    {
+        ImGui::Text("%6d/%-6d %6d lines  | read-only (large file) | %s", mLargeFileView->cursorLine() + 1, 1,
+                    mLargeFileView->nbLines(), filename);
+        return;
+    }
+    auto & editor = *mEditor;
     auto cpos = editor.GetCursorPosition();
     ImGui::Text("%6d/%-6d %6d lines  | %s | %s | %s | %s", cpos.mLine + 1, cpos.mColumn + 1, editor.GetTotalLines(),
                 editor.IsOverwrite() ? "Ovr" : "Ins",
                 editor.CanUndo() ? "*" : " ",
-                editor.GetLanguageDefinition().mName.c_str(), filename.c_str());
+                editor.GetLanguageDefinition().mName.c_str(), filename);
 }
 
 void WindowWithEditor::guiFind()
 {
+    Profiler::ScopedTimer scopedTimer("WindowWithEditor::guiFind");
     ImGui::SameLine();
     // Draw filter
-    bool filterChanged = false;
     {
         ImGui::SetNextItemWidth(100.f);
-        filterChanged = mFilter.Draw("Search code"); ImGui::SameLine();
+        mFilter.Draw("Search code"); ImGui::SameLine();
         ImGui::SameLine();
         ImGui::TextDisabled("?");
         if (ImGui::IsItemHovered())
             ImGui::SetTooltip("Filter using -exc,inc. For example search for '-widgets,DemoCode'");
         ImGui::SameLine();
     }
-    // If changed, check number of matches
-    if (filterChanged)
-    {
-        const auto & lines = mEditor.GetTextLines();
-        mNbFindMatches = (int)fplus::count_if([this](auto s){ return mFilter.PassFilter(s.c_str());}, lines);
-    }
+    // The matches are cached, and only recomputed when the filter or the text changes
+    if (mLargeFileView)
+        mSearch.update(mLargeFileView->text(), mFilter);
+    else
+        mSearch.update(*mEditor, mFilter);
 
-    // Draw number of matches
+    // Draw number of matches (an empty filter matches every line: the arrows then go line by line)
+    int currentLine = cursorLine();
+    if (mFilter.IsActive() && mSearch.nbMatches() > 0)
     {
-        if (mNbFindMatches > 0)
-        {
-            const auto & lines = mEditor.GetTextLines();
-            bool thisLineMatch = mFilter.PassFilter(mEditor.GetCurrentLineText().c_str());
-            if (!thisLineMatch)
-                ImGui::Text("---/%3i", mNbFindMatches);
-            else
-            {
-                std::vector<size_t> allMatchingLinesNumbers =
-                    fplus::find_all_idxs_by(
-                        [this](const std::string& s) {
-                          return mFilter.PassFilter(s.c_str());
-                        },
-                        lines);
-                auto matchNumber = fplus::find_first_idx(
-                    (size_t)mEditor.GetCursorPosition().mLine,
-                    allMatchingLinesNumbers);
-                if (matchNumber.is_just())
-                    ImGui::Text("%3i/%3i", (int)matchNumber.unsafe_get_just() + 1, mNbFindMatches);
-                else
-                    ImGui::Text("Houston, we have a bug");
-                ImGui::SameLine();
-            }
-            ImGui::SameLine();
-        }
+        int rank = mSearch.rankOf(currentLine);
+        if (rank < 0)
+            ImGui::Text("---/%3i", mSearch.nbMatches());
+        else
+            ImGui::Text("%3i/%3i", rank + 1, mSearch.nbMatches());
         ImGui::SameLine();
     }
 
@@ -93,40 +269,21 @@ void WindowWithEditor::guiFind()
     {
         bool searchDown = ImGui::SmallButton(ICON_FA_ARROW_DOWN); ImGui::SameLine();
         bool searchUp = ImGui::SmallButton(ICON_FA_ARROW_UP); ImGui::SameLine();
-        std::vector<std::string> linesToSearch;
-        int currentLine = mEditor.GetCursorPosition().mLine ;
+        int targetLine = -1;
         if (searchUp)
-        {
-            const auto & lines = mEditor.GetTextLines();
-            linesToSearch = fplus::get_segment(0, currentLine, lines);
-            auto line_idx = fplus::find_last_idx_by(
-                [this](const std::string &line) {
-                  return mFilter.PassFilter(line.c_str());
-                },
-                linesToSearch);
-            if (line_idx.is_just())
-                mEditor.SetCursorPosition({(int)line_idx.unsafe_get_just(), 0});
-        }
+            targetLine = mSearch.previousMatch(currentLine);
         if (searchDown)
-        {
-            const auto &lines = mEditor.GetTextLines();
-            linesToSearch = fplus::get_segment(currentLine + 1, lines.size(), lines);
-            auto line_idx = fplus::find_first_idx_by(
-                [this](const std::string &line) {
-                  return mFilter.PassFilter(line.c_str());
-                },
-                linesToSearch);
-            if (line_idx.is_just())
-                mEditor.SetCursorPosition({(int)line_idx.unsafe_get_just() + currentLine + 1, 0});
-        }
+            targetLine = mSearch.nextMatch(currentLine);
+        if (targetLine >= 0)
+            setCursorLine(targetLine);
     }
 
     ImGui::SameLine();
 }
 
-void WindowWithEditor::guiIconBar(VoidFunction additionalGui)
+void WindowWithEditor::guiEditButtons()
 {
-    auto & editor = mEditor;
+    auto & editor = *mEditor;
     static bool canWrite = ! editor.IsReadOnly();
     if (ImGui::Checkbox(ICON_FA_EDIT, &canWrite))
         editor.SetReadOnly(!canWrite);
@@ -134,15 +291,41 @@ void WindowWithEditor::guiIconBar(VoidFunction additionalGui)
         ImGui::SetTooltip("Enable editing this file");
     ImGui::SameLine();
     if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_UNDO, editor.CanUndo() && canWrite, "Undo", true))
+    {
         editor.Undo();
+        mSearch.onTextEdited();
+    }
     if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_REDO, editor.CanRedo() && canWrite, "Redo", true))
+    {
         editor.Redo();
+        mSearch.onTextEdited();
+    }
     if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_COPY, editor.HasSelection(), "Copy", true))
         editor.Copy();
     if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_CUT, editor.HasSelection() && canWrite, "Cut", true))
+    {
         editor.Cut();
+        mSearch.onTextEdited();
+    }
     if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_PASTE, (ImGui::GetClipboardText() != nullptr)  && canWrite, "Paste", true))
+    {
         editor.Paste();
+        mSearch.onTextEdited();
+    }
+
+}
+
+void WindowWithEditor::guiIconBar(VoidFunction additionalGui)
+{
+    if (mLargeFileView)
+    {
+        ImGui::TextDisabled(ICON_FA_EDIT);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Large files are shown read-only");
+        ImGui::SameLine();
+    }
+    else
+        guiEditButtons();
 
     // missing icon from font awesome
     // if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_SELECT_ALL, ImGui::GetClipboardText() != nullptr, true))
@@ -160,22 +343,154 @@ void WindowWithEditor::guiIconBar(VoidFunction additionalGui)
 
     guiFind();
 
+    if (ImGuiExt::SmallButton_WithEnabledFlag(ICON_FA_CROSSHAIRS, !mLargeFileView,
+                                              "Definition and usages of the word under the cursor\n"
+                                              "Ctrl+click on a word: go to its definition\n"
+                                              "Ctrl+Shift+click on a word: this list", true))
+        openSymbolPopup(wordUnderCursor());
+
     if (additionalGui)
         additionalGui();
 
     ImGui::NewLine();
 }
 
+std::string WindowWithEditor::wordUnderCursor() const
+{
+    if (mLargeFileView)
+        return "";
+    // The cursor column counts the glyphs, with the tabs expanded
+    std::string line = mEditor->GetCurrentLineText();
+    int column = mEditor->GetCursorPosition().mColumn;
+    int tabSize = std::max(1, mEditor->GetTabSize());
+    size_t i = 0;
+    for (int c = 0; i < line.size() && c < column;)
+    {
+        c = (line[i] == '\t') ? (c / tabSize + 1) * tabSize : c + 1;
+        ++i;
+        while (i < line.size() && ((unsigned char)line[i] & 0xC0) == 0x80)
+            ++i;
+    }
+    auto isIdentifierChar = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    };
+    size_t start = i, end = i;
+    while (start > 0 && isIdentifierChar(line[start - 1]))
+        --start;
+    while (end < line.size() && isIdentifierChar(line[end]))
+        ++end;
+    return line.substr(start, end - start);
+}
+
+void WindowWithEditor::goToDefinition(const std::string &name)
+{
+    std::vector<SymbolIndex::Location> locations;
+    for (auto &location : SymbolIndex::FindDefinitions(name))
+        if (CodeNavigation::CanShow(location.sourcePath))
+            locations.push_back(location);
+    if (locations.empty())
+    {
+        openSymbolPopup(name); // which tells why
+        return;
+    }
+    // Clicking again on the word goes to the next location (e.g. from the definition to the declaration)
+    size_t next = 0;
+    for (size_t i = 0; i < locations.size(); ++i)
+        if (locations[i].sourcePath == mEditorSource.sourcePath && locations[i].lineNumber == cursorLine())
+            next = (i + 1) % locations.size();
+    CodeNavigation::RequestShow(locations[next].sourcePath, locations[next].lineNumber);
+}
+
+void WindowWithEditor::openSymbolPopup(const std::string &name)
+{
+    querySymbol(name);
+    ImGui::OpenPopup("symbol_popup");
+}
+
+void WindowWithEditor::querySymbol(const std::string &name)
+{
+    mSymbolQuery.name = name;
+    mSymbolQuery.isIndexReady = SymbolIndex::IsReady();
+    mSymbolQuery.definitions = SymbolIndex::FindDefinitions(name);
+    auto start = std::chrono::steady_clock::now();
+    mSymbolQuery.usages = SymbolIndex::FindUsages(name);
+    mSymbolQuery.usagesDurationMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void WindowWithEditor::guiSymbolPopup()
+{
+    if (!ImGui::BeginPopup("symbol_popup"))
+        return;
+    // The first lookup starts the build of the index: query again once it is built
+    if (!mSymbolQuery.isIndexReady && SymbolIndex::IsReady())
+        querySymbol(mSymbolQuery.name);
+    const SymbolQuery &query = mSymbolQuery;
+    if (query.name.empty())
+        ImGui::TextDisabled("Place the cursor on a word");
+    else if (!SymbolIndex::IsReady())
+        ImGui::TextDisabled("The symbol index is being built...");
+    else
+    {
+        ImGui::Text("%s", query.name.c_str());
+        ImGui::Separator();
+        if (query.definitions.empty())
+            ImGui::TextDisabled("No definition found in the ImGui sources");
+        for (size_t i = 0; i < query.definitions.size(); ++i)
+        {
+            const auto &location = query.definitions[i];
+            bool canShow = CodeNavigation::CanShow(location.sourcePath);
+            const char *label = FrameArena::Format("%s%s  %s:%d##definition%zu", SymbolTable::KindName(location.kind),
+                                                   location.isDefinition ? "" : " (declaration)",
+                                                   location.sourcePath.c_str(), location.lineNumber + 1, i);
+            if (ImGui::Selectable(label, false, canShow ? 0 : ImGuiSelectableFlags_Disabled))
+            {
+                CodeNavigation::RequestShow(location.sourcePath, location.lineNumber);
+                ImGui::CloseCurrentPopup();
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("%zu usages in %s", query.usages.size(), SymbolIndex::UsagesSourcePath().c_str());
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%.2f ms)", query.usagesDurationMs);
+        float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        float height = std::min((float)query.usages.size(), 15.f) * lineHeight + ImGui::GetStyle().WindowPadding.y * 2.f;
+        if (!query.usages.empty())
+        {
+            ImGui::BeginChild("usages", ImVec2(700.f, height), true);
+            ImGuiListClipper clipper;
+            clipper.Begin((int)query.usages.size());
+            while (clipper.Step())
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                {
+                    const auto &usage = query.usages[(size_t)i];
+                    const char *label = FrameArena::Format("%5d  %.*s##usage%d", usage.lineNumber + 1,
+                                                           (int)usage.lineText.size(), usage.lineText.data(), i);
+                    if (ImGui::Selectable(label))
+                    {
+                        CodeNavigation::RequestShow(SymbolIndex::UsagesSourcePath(), usage.lineNumber);
+                        ImGui::CloseCurrentPopup();
+                    }
+                }
+            ImGui::EndChild();
+        }
+    }
+    ImGui::EndPopup();
+}
+
+void setAllEditorsPalette(const TextEditor::Palette &palette)
+{
+    gEditorPalette = palette;
+}
+
 void menuEditorTheme()
 {
     ImGui::MenuItem("Editor", NULL, false, false);
     if (ImGui::MenuItem("Dark palette"))
-        for (auto editor: gAllEditors)
-            editor->SetPalette(TextEditor::GetDarkPalette());
+        setAllEditorsPalette(TextEditor::GetDarkPalette());
     if (ImGui::MenuItem("Light palette"))
-        for (auto editor: gAllEditors)
-            editor->SetPalette(TextEditor::GetLightPalette());
+        setAllEditorsPalette(TextEditor::GetLightPalette());
     if (ImGui::MenuItem("Retro blue palette"))
-        for (auto editor: gAllEditors)
-            editor->SetPalette(TextEditor::GetRetroBluePalette());
+        setAllEditorsPalette(TextEditor::GetRetroBluePalette());
 }
@@ -1,30 +1,101 @@
 #pragma once
+#include "EditorSearch.h"
+#include "EditorSnapshot.h"
+#include "LargeFileView.h"
+#include "SourceCache.h"
 #include "Sources.h"
+#include "SymbolIndex.h"
 #include "TextEditor.h"
 #include "imgui.h"
+#include <functional>
+#include <memory>
+#include <string>
 
+struct ImGuiWindow;
 
 using VoidFunction = std::function<void(void)>;
 
 class WindowWithEditor
 {
 public:
-    WindowWithEditor();
+    // windowName identifies the editors of this window in SourceCache: it shall be stable
+    // (the window may be freed and made again) and unique among the windows
+    explicit WindowWithEditor(std::string windowName);
+    virtual ~WindowWithEditor();
 
     void setEditorAnnotatedSource(const Sources::AnnotatedSource &annotatedSource);
-    void RenderEditor(const std::string& filename, VoidFunction additionalGui = {});
+    // Runs loader in the background (see WorkerPool); the window shows a "loading" state
+    // until the source is set into the editor. onLoaded is then called on the ui thread.
+    void setEditorAnnotatedSourceAsync(
+        std::function<Sources::AnnotatedSource(void)> loader,
+        std::function<void(Sources::AnnotatedSource &)> onLoaded = {});
+    bool isEditorLoading() const { return mIsLoading; }
+    void RenderEditor(const char *filename, VoidFunction additionalGui = {});
 
-    TextEditor * _GetTextEditorPtr() { return &mEditor; }
+    // Line numbers are 0 based. With cursorLineOnPage >= 0, the line is scrolled
+    // to this position from the top of the view.
+    int cursorLine() const;
+    void setCursorLine(int lineNumber, int cursorLineOnPage = -1);
+    // Sets the text of the search field, as if it was typed (e.g. by imgui_manual_bench)
+    void setSearchFilter(const std::string &filterText);
+
+    // Moves the editor state out of this window, which has no editor until it shows a source again
+    EditorSnapshot saveEditorSnapshot();
+    void restoreEditorSnapshot(EditorSnapshot snapshot);
 
 private:
-    void guiStatusLine(const std::string& filename);
+    // The child window in which mEditor was rendered, or nullptr
+    ImGuiWindow *findEditorChildWindow(const char *filename) const;
+    void guiStatusLine(const char *filename);
     void guiFind();
     void guiIconBar(VoidFunction additionalGui);
+    void guiEditButtons();
+    void guiSymbolPopup();
+    void putEditorSnapshotIntoCache();
+    SourceCache::EditorKey editorKey() const { return {mWindowName, mIsEditorSourceAnnotated}; }
+    // Makes mEditor and mColorizer, if the window has none
+    void ensureEditor();
+
+    // Symbols (see SymbolIndex): Ctrl+click goes to the definition of a word,
+    // Ctrl+Shift+click shows its definitions and its usages in a popup
+    std::string wordUnderCursor() const;
+    void goToDefinition(const std::string &name);
+    void openSymbolPopup(const std::string &name);
+    void querySymbol(const std::string &name); // into mSymbolQuery
 
 protected:
-    TextEditor mEditor;
+    // Always set the editor text through this, so that the search cache stays in sync
+    void setEditorText(std::string_view text);
+    // Shows a source in the editor. The snapshot of the current source is put into SourceCache,
+    // and the snapshot that this window left for the new one (shown the same way, annotated or not)
+    // is restored from it if possible, so that a source is tokenized and colorized only once.
+    // Large sources are shown by a LargeFileView instead.
+    void setEditorSource(const Sources::Source &source, bool isAnnotated = false);
+    static std::shared_ptr<TextEditor> MakeEditor();
+
+    // Null until the window shows a source, and after saveEditorSnapshot()
+    std::shared_ptr<TextEditor> mEditor;
+    std::shared_ptr<EditorColorizer> mColorizer;
+    Sources::Source mEditorSource; // set by setEditorSource
+    bool mIsEditorSourceAnnotated = false;
+    std::string mWindowName;
+    float mEditorScrollY = 0.f;    // updated after each render
+    float mPendingEditorScrollY = -1.f;
+    std::unique_ptr<LargeFileView> mLargeFileView; // only for large sources: mEditor is then empty
     ImGuiTextFilter mFilter;
-    int mNbFindMatches = 0;
+    EditorSearch mSearch;
+    bool mIsLoading = false;
+    struct SymbolQuery
+    {
+        std::string name;
+        std::vector<SymbolIndex::Location> definitions;
+        std::vector<SymbolTable::Usage> usages;
+        double usagesDurationMs = 0.;
+        bool isIndexReady = false; // when the query was made
+    };
+    SymbolQuery mSymbolQuery; // shown by guiSymbolPopup
+    // Pending background loads check this token, since they may finish after this window was freed
+    std::shared_ptr<bool> mAliveToken = std::make_shared<bool>(true);
 };
 
 void menuEditorTheme();
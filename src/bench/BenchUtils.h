@@ -0,0 +1,52 @@
+#pragma once
+// Small helpers shared by the benchmarks in src/bench
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace BenchUtils
+{
+    // IMGUI_MANUAL_ASSETS_DIR is src/assets (populated by populate_assets.sh)
+    inline std::string AssetPath(const std::string &relativePath)
+    {
+        return std::string(IMGUI_MANUAL_ASSETS_DIR) + "/" + relativePath;
+    }
+
+    inline std::string ReadFile(const std::string &path)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is.good())
+        {
+            fprintf(stderr, "Cannot read %s (did populate_assets.sh run?)\n", path.c_str());
+            exit(1);
+        }
+        std::stringstream ss;
+        ss << is.rdbuf();
+        return ss.str();
+    }
+
+    // Runs fn nbIterations times, and returns the best duration of a run, in milliseconds
+    template <typename Fn>
+    double BestTimeMs(int nbIterations, Fn fn)
+    {
+        double best = 1e30;
+        for (int i = 0; i < nbIterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    inline double MegaBytesPerSecond(size_t nbBytes, double ms)
+    {
+        return ((double)nbBytes / (1024. * 1024.)) / (ms / 1000.);
+    }
+}
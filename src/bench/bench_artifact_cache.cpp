@@ -0,0 +1,91 @@
+// Measures the ArtifactCache on the real ImGui sources: the work done when a source is opened,
+// at the first launch (cold: computed, then stored) and at the next ones (warm: read back from the cache)
+// - tags:   the doc titles of imgui.cpp and the DemoCode() markers of imgui_demo.cpp (see TagScanner)
+// - tokens: the colorizer tokens of all the lines of a source (see EditorColorizer), i.e. the time
+//           until an editor is fully colorized, with frames run back to back
+// The cache is stored in ./bench_artifact_cache (as XDG_CACHE_HOME), which is cleared before each cold run.
+//
+// Usage: bench_artifact_cache [nb_iterations]
+#include "BenchUtils.h"
+#include "EditorColorizer.h"
+#include "TagScanner.h"
+#include "utilities/ArtifactCache.h"
+#include "utilities/WorkerPool.h"
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace
+{
+    const std::vector<std::string> kSourcePaths = {
+        "code/imgui/imgui.h", "code/imgui/imgui_internal.h", "code/imgui/imgui.cpp",
+        "code/imgui/imgui_draw.cpp", "code/imgui/imgui_widgets.cpp", "code/imgui/imgui_demo.cpp"};
+
+    // Runs frames (without any delay between them) until the colorizer is complete
+    void ColorizeUntilComplete(const std::string &source)
+    {
+        TextEditor editor;
+        EditorColorizer colorizer;
+        colorizer.onTextReplaced(source);
+        while (!colorizer.isComplete())
+        {
+            colorizer.beginRender(editor, 0, 50);
+            colorizer.endRender();
+            WorkerPool::ProcessFrame(/*timeBudgetMs=*/ 8.);
+        }
+    }
+
+    // Waits for the background jobs (e.g. those that store the artifacts)
+    void WaitForWorkers()
+    {
+        while (WorkerPool::IsBusy())
+            WorkerPool::ProcessFrame(/*timeBudgetMs=*/ 8.);
+    }
+
+    void Measure(const char *what, const std::string &sourcePath, int nbIterations, const std::function<void()> &fn)
+    {
+        double coldMs = BenchUtils::BestTimeMs(nbIterations, [&] {
+            ArtifactCache::Clear();
+            fn();
+            WaitForWorkers();
+        });
+        double warmMs = BenchUtils::BestTimeMs(nbIterations, [&] {
+            fn();
+            WaitForWorkers();
+        });
+        printf("    %-6s %-28s cold %8.2f ms, warm %8.2f ms (x%.1f)\n",
+               what, sourcePath.c_str(), coldMs, warmMs, coldMs / warmMs);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 5;
+    // Before the first use of CacheDir
+    setenv("XDG_CACHE_HOME", "bench_artifact_cache", 1);
+
+    std::vector<std::string> sources;
+    for (const auto &sourcePath : kSourcePaths)
+        sources.push_back(BenchUtils::ReadFile(BenchUtils::AssetPath(sourcePath)));
+
+    printf("Cold (computed, then stored) vs warm (read from the cache), best of %d:\n", nbIterations);
+    Measure("tags", "code/imgui/imgui.cpp", nbIterations,
+            [&] { Sources::ScanImGuiCppDocTagsCached(sources[2]); });
+    Measure("tags", "code/imgui/imgui_demo.cpp", nbIterations,
+            [&] { Sources::ScanImGuiDemoCodeTagsCached(sources[5]); });
+    for (size_t i = 0; i < sources.size(); ++i)
+        Measure("tokens", kSourcePaths[i], nbIterations, [&] { ColorizeUntilComplete(sources[i]); });
+
+    // The cache as it is after a launch that opened all the sources
+    ArtifactCache::Clear();
+    for (const auto &source : sources)
+        ColorizeUntilComplete(source);
+    WaitForWorkers();
+    auto stats = ArtifactCache::GetStats();
+    size_t nbSourceBytes = 0;
+    for (const auto &source : sources)
+        nbSourceBytes += source.size();
+    printf("Tokens of the %zu sources: %d files, %.1f KB on disk (sources: %.1f KB)\n",
+           sources.size(), stats.nbFiles, (double)stats.nbBytes / 1024., (double)nbSourceBytes / 1024.);
+    return 0;
+}
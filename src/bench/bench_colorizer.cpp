@@ -0,0 +1,159 @@
+// Colorizes every .cpp / .h file of assets/code with the token rules of
+// TextEditor::LanguageDefinition::CPlusPlus() (std::regex), and with CppTokenizer,
+// and reports their speed and whether they give the same palette indices.
+//
+// Usage: bench_colorizer [nb_iterations]
+#include "BenchUtils.h"
+#include "CppTokenizer.h"
+#include "TextEditor.h"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <regex>
+#include <vector>
+
+using PaletteIndex = TextEditor::PaletteIndex;
+using Colors = std::vector<PaletteIndex>;
+
+std::vector<std::string> SplitLines(const std::string &text)
+{
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string line = text.substr(start, end - start);
+        // TextEditor drops '\r'
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        lines.push_back(line);
+        start = end + 1;
+    }
+    return lines;
+}
+
+// The loop of TextEditor::ColorizeRange, for one line: at each position, the first token
+// found by the tokenizer or the regexes is colored, otherwise the position moves by one character.
+using TokenizeFunction = std::function<bool(const char *, const char *, const char *&, const char *&, PaletteIndex &)>;
+
+void ColorizeLine(const std::string &line, const TokenizeFunction &tokenize, Colors *colors)
+{
+    colors->assign(line.size(), PaletteIndex::Default);
+    const char *bufferBegin = line.data();
+    const char *last = bufferBegin + line.size();
+    for (const char *first = bufferBegin; first < last;)
+    {
+        const char *tokenBegin = nullptr, *tokenEnd = nullptr;
+        PaletteIndex tokenColor = PaletteIndex::Default;
+        if (!tokenize(first, last, tokenBegin, tokenEnd, tokenColor))
+        {
+            ++first;
+            continue;
+        }
+        std::fill(colors->begin() + (tokenBegin - bufferBegin), colors->begin() + (tokenEnd - bufferBegin), tokenColor);
+        first = std::max(tokenEnd, first + 1);
+    }
+}
+
+TokenizeFunction MakeReferenceTokenize(std::string *engineName)
+{
+    const auto &definition = TextEditor::LanguageDefinition::CPlusPlus();
+    if (definition.mTokenize != nullptr)
+    {
+        *engineName = "CPlusPlus() tokenizer";
+        return definition.mTokenize;
+    }
+    *engineName = "CPlusPlus() std::regex rules";
+    auto regexes = std::make_shared<std::vector<std::pair<std::regex, PaletteIndex>>>();
+    for (const auto &rule : definition.mTokenRegexStrings)
+        regexes->push_back({std::regex(rule.first, std::regex_constants::optimize), rule.second});
+    return [regexes](const char *inBegin, const char *inEnd, const char *&outBegin, const char *&outEnd, PaletteIndex &paletteIndex) {
+        std::cmatch results;
+        for (const auto &rule : *regexes)
+        {
+            if (std::regex_search(inBegin, inEnd, results, rule.first, std::regex_constants::match_continuous))
+            {
+                outBegin = results[0].first;
+                outEnd = results[0].second;
+                paletteIndex = rule.second;
+                return true;
+            }
+        }
+        return false;
+    };
+}
+
+struct EngineResult
+{
+    double ms = 0.;
+    std::vector<Colors> lineColors;
+};
+
+EngineResult RunEngine(const std::vector<std::string> &lines, const TokenizeFunction &tokenize, int nbIterations)
+{
+    EngineResult r;
+    r.lineColors.resize(lines.size());
+    r.ms = BenchUtils::BestTimeMs(nbIterations, [&] {
+        for (size_t i = 0; i < lines.size(); ++i)
+            ColorizeLine(lines[i], tokenize, &r.lineColors[i]);
+    });
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 3;
+    std::string referenceName;
+    TokenizeFunction reference = MakeReferenceTokenize(&referenceName);
+    TokenizeFunction native = CppTokenizer::Tokenize;
+
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(BenchUtils::AssetPath("code")))
+    {
+        auto extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".cpp" || extension == ".h"))
+            files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    printf("Reference: %s\n", referenceName.c_str());
+    printf("%-48s %9s %12s %12s %8s %s\n", "file", "KB", "ref MB/s", "native MB/s", "speedup", "parity");
+    size_t totalBytes = 0, totalDifferentLines = 0, totalLines = 0;
+    double totalReferenceMs = 0., totalNativeMs = 0.;
+    for (const auto &file : files)
+    {
+        std::string text = BenchUtils::ReadFile(file.string());
+        std::vector<std::string> lines = SplitLines(text);
+        EngineResult referenceResult = RunEngine(lines, reference, nbIterations);
+        EngineResult nativeResult = RunEngine(lines, native, nbIterations);
+
+        size_t nbDifferentLines = 0;
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            if (referenceResult.lineColors[i] == nativeResult.lineColors[i])
+                continue;
+            if (nbDifferentLines == 0)
+                fprintf(stderr, "%s:%zu differs: %s\n", file.string().c_str(), i + 1, lines[i].c_str());
+            ++nbDifferentLines;
+        }
+
+        std::string name = std::filesystem::relative(file, BenchUtils::AssetPath("code")).string();
+        printf("%-48s %9.1f %12.2f %12.2f %7.1fx %s\n", name.c_str(), (double)text.size() / 1024.,
+               BenchUtils::MegaBytesPerSecond(text.size(), referenceResult.ms),
+               BenchUtils::MegaBytesPerSecond(text.size(), nativeResult.ms),
+               referenceResult.ms / nativeResult.ms,
+               nbDifferentLines == 0 ? "same" : (std::to_string(nbDifferentLines) + " lines differ").c_str());
+        totalBytes += text.size();
+        totalLines += lines.size();
+        totalDifferentLines += nbDifferentLines;
+        totalReferenceMs += referenceResult.ms;
+        totalNativeMs += nativeResult.ms;
+    }
+    printf("Total: %zu files, %.1f MB, reference %.2f MB/s, native %.2f MB/s (x%.1f), %zu / %zu lines differ\n",
+           files.size(), (double)totalBytes / (1024. * 1024.),
+           BenchUtils::MegaBytesPerSecond(totalBytes, totalReferenceMs),
+           BenchUtils::MegaBytesPerSecond(totalBytes, totalNativeMs),
+           totalReferenceMs / totalNativeMs, totalDifferentLines, totalLines);
+    return totalDifferentLines == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+// Measures the startup cost of the fonts: the time to build (or restore) the font atlas, and its memory.
+// - legacy: the four fonts as MarkdownHelper::LoadFonts loaded them (each one merged with the whole
+//   FontAwesome range), rasterized at each launch, and their TTF data kept by the atlas
+// - cold:   FontAtlasCache with only the icons used by the manual, first launch (built, then saved)
+// - warm:   FontAtlasCache, next launches (restored from the cache file)
+//
+// Usage: bench_font_atlas [nb_iterations]
+#include "BenchUtils.h"
+#include "utilities/FontAtlasCache.h"
+#include "utilities/MarkdownHelper.h"
+#include "hello_imgui/hello_imgui.h"
+
+namespace
+{
+    const std::string kCacheFilePath = "bench_font_atlas.bin";
+
+    struct AtlasMemory
+    {
+        int textureWidth = 0, textureHeight = 0;
+        size_t textureBytes = 0;    // alpha8 texture
+        size_t glyphTablesBytes = 0;
+        size_t ttfBytes = 0;        // TTF data kept by the atlas
+        int nbGlyphs = 0;
+    };
+
+    AtlasMemory MeasureAtlas(const ImFontAtlas &atlas)
+    {
+        AtlasMemory r;
+        r.textureWidth = atlas.TexWidth;
+        r.textureHeight = atlas.TexHeight;
+        r.textureBytes = (size_t)atlas.TexWidth * (size_t)atlas.TexHeight;
+        for (const ImFont *font : atlas.Fonts)
+        {
+            r.nbGlyphs += font->Glyphs.Size;
+            r.glyphTablesBytes += (size_t)font->Glyphs.Size * sizeof(ImFontGlyph)
+                                  + (size_t)font->IndexAdvanceX.Size * sizeof(float)
+                                  + (size_t)font->IndexLookup.Size * sizeof(ImWchar);
+        }
+        for (const auto &config : atlas.ConfigData)
+            if (config.FontDataOwnedByAtlas)
+                r.ttfBytes += (size_t)config.FontDataSize;
+        return r;
+    }
+
+    void LoadLegacyFonts()
+    {
+        HelloImGui::ImGuiDefaultSettings::LoadDefaultFont_WithFontAwesomeIcons();
+        std::string fontFilename = "fonts/DroidSans.ttf";
+        float fontSizeStep = 4.;
+        for (int i = 1; i <= 3; ++i)
+            HelloImGui::LoadFontTTF_WithFontAwesomeIcons(fontFilename, 14.f + fontSizeStep * (float)i);
+        ImGui::GetIO().Fonts->Build();
+    }
+
+    // Each run starts from a new ImGui context, as a launch would
+    template <typename LoadFunction>
+    void BenchScenario(const char *name, int nbIterations, LoadFunction loadFunction)
+    {
+        AtlasMemory memory;
+        double ms = BenchUtils::BestTimeMs(nbIterations, [&] {
+            ImGui::CreateContext();
+            loadFunction();
+            memory = MeasureAtlas(*ImGui::GetIO().Fonts);
+            ImGui::DestroyContext();
+        });
+        printf("%-7s: %8.2f ms  texture %4dx%-4d (%6.1f KB)  %5d glyphs (%6.1f KB)  TTF data kept %6.1f KB\n",
+               name, ms, memory.textureWidth, memory.textureHeight, (double)memory.textureBytes / 1024.,
+               memory.nbGlyphs, (double)memory.glyphTablesBytes / 1024., (double)memory.ttfBytes / 1024.);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 10;
+    // The fonts are assets of hello_imgui
+    HelloImGui::overrideAssetsFolder(HELLO_IMGUI_ASSETS_DIR);
+
+    printf("Font atlas (best of %d runs, including the creation of the ImGui context)\n", nbIterations);
+    BenchScenario("legacy", nbIterations, LoadLegacyFonts);
+    BenchScenario("cold", nbIterations, [] {
+        remove(kCacheFilePath.c_str());
+        FontAtlasCache::LoadFonts(MarkdownHelper::FontAtlasSpec(), kCacheFilePath);
+    });
+    BenchScenario("warm", nbIterations, [] {
+        FontAtlasCache::LoadFonts(MarkdownHelper::FontAtlasSpec(), kCacheFilePath);
+    });
+    remove(kCacheFilePath.c_str());
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Measures the memory taken by the sources that are shown when all the browsers of the manual are open:
+// imgui_demo.cpp and imgui.cpp (which are scanned for their tags), and the sources that the library browsers
+// open at first (imgui.h and ImGuiManual.cpp).
+// - legacy:  Sources::ReadSource as it was: the asset data copied into a std::string, which each browser kept
+// - buffers: Sources::Source, a view on a SourceBuffer (the memory mapped asset on linux and macOS)
+// In both cases, the text is read once (as by the tag scan), and copied while it is set into a TextEditor
+// (whose own copy, the same in both cases, is not counted).
+// The peak RSS is per process: each scenario runs in a process of its own.
+// Run it on the real assets (populate_assets.sh): its results with other files say nothing about the app.
+//
+// Usage: bench_source_memory [legacy|buffers]
+#include "BenchUtils.h"
+#include "SourceBuffer.h"
+#include "utilities/MemoryUsage.h"
+#include "hello_imgui/hello_imgui.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::vector<std::string> kSourcePaths = {
+        "imgui/imgui_demo.cpp", "imgui/imgui.cpp", "imgui/imgui.h", "imgui_manual/ImGuiManual.cpp"};
+
+    volatile size_t gSink = 0;
+
+    // Reads the whole text, as the tag scan does
+    void ReadText(std::string_view text)
+    {
+        size_t nbLines = 0;
+        for (char c : text)
+            nbLines += (c == '\n');
+        gSink = gSink + nbLines;
+    }
+
+    // The copy made for TextEditor::SetText, freed once the text is set
+    void SetEditorText(std::string_view text)
+    {
+        std::string editorText(text);
+        gSink = gSink + editorText.size();
+    }
+
+    // ReadSource before SourceBuffer: the asset data (read as by LoadAssetFileData) was copied into a std::string,
+    // then freed
+    std::string LegacyReadSource(const std::string &sourcePath)
+    {
+        std::string path = BenchUtils::AssetPath("code/" + sourcePath);
+        FILE *f = fopen(path.c_str(), "rb");
+        if (f == nullptr)
+        {
+            fprintf(stderr, "Cannot read %s (did populate_assets.sh run?)\n", path.c_str());
+            exit(1);
+        }
+        fseek(f, 0, SEEK_END);
+        size_t size = (size_t)ftell(f);
+        fseek(f, 0, SEEK_SET);
+        auto assetData = std::make_unique<char[]>(size + 1);
+        size_t nbRead = fread(assetData.get(), 1, size, f);
+        fclose(f);
+        assetData[nbRead] = '\0';
+        return std::string(assetData.get());
+    }
+
+    void Report(const char *name, size_t startRss, size_t nbSourceBytes)
+    {
+        size_t rss = MemoryUsage::CurrentRssBytes(), peakRss = MemoryUsage::PeakRssBytes();
+        printf("%-7s: %zu sources (%6.1f KB)  RSS %7.1f KB (+%6.1f KB)  peak RSS %7.1f KB (+%6.1f KB)\n",
+               name, kSourcePaths.size(), (double)nbSourceBytes / 1024.,
+               (double)rss / 1024., (double)(rss - startRss) / 1024.,
+               (double)peakRss / 1024., (double)(peakRss - startRss) / 1024.);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::string command(argv[0]);
+        return (system((command + " legacy").c_str()) == 0 && system((command + " buffers").c_str()) == 0) ? 0 : 1;
+    }
+    std::string scenario = argv[1];
+    HelloImGui::overrideAssetsFolder(IMGUI_MANUAL_ASSETS_DIR);
+    size_t startRss = MemoryUsage::CurrentRssBytes();
+    size_t nbSourceBytes = 0;
+    if (scenario == "legacy")
+    {
+        std::vector<std::string> sources;
+        for (const auto &sourcePath : kSourcePaths)
+        {
+            sources.push_back(LegacyReadSource(sourcePath));
+            ReadText(sources.back());
+            // SetText took a const std::string &
+            nbSourceBytes += sources.back().size();
+        }
+        Report("legacy", startRss, nbSourceBytes);
+    }
+    else if (scenario == "buffers")
+    {
+        std::vector<std::shared_ptr<const SourceBuffer>> sources;
+        for (const auto &sourcePath : kSourcePaths)
+        {
+            sources.push_back(SourceBuffer::FromAsset("code/" + sourcePath));
+            ReadText(sources.back()->view());
+            SetEditorText(sources.back()->view());
+            nbSourceBytes += sources.back()->view().size();
+        }
+        Report("buffers", startRss, nbSourceBytes);
+    }
+    else
+    {
+        fprintf(stderr, "Usage: bench_source_memory [legacy|buffers]\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Measures the symbol index (see SymbolTable) on the real ImGui sources:
+// the time to build it, the time of a "go to definition" lookup, and the time to find
+// the usages of a symbol in imgui_demo.cpp.
+//
+// Usage: bench_symbol_index [nb_iterations]
+#include "BenchUtils.h"
+#include "SymbolTable.h"
+#include <vector>
+
+namespace
+{
+    const std::vector<std::string> kSourcePaths = {
+        "code/imgui/imgui.h", "code/imgui/imgui_internal.h", "code/imgui/imgui.cpp",
+        "code/imgui/imgui_draw.cpp", "code/imgui/imgui_widgets.cpp", "code/imgui/imgui_demo.cpp"};
+    const std::vector<std::string> kNames = {
+        "Begin", "BeginTable", "ImVec2", "ImGuiWindow", "ImGuiWindowFlags_NoTitleBar", "GImGui",
+        "IM_ASSERT", "ImTextureID", "ShowDemoWindow", "ExampleAppConsole", "NotASymbol"};
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 20;
+    std::vector<std::string> sources;
+    size_t nbBytes = 0;
+    for (const auto &sourcePath : kSourcePaths)
+    {
+        sources.push_back(BenchUtils::ReadFile(BenchUtils::AssetPath(sourcePath)));
+        nbBytes += sources.back().size();
+    }
+
+    SymbolTable table;
+    double buildMs = BenchUtils::BestTimeMs(nbIterations, [&] {
+        table = SymbolTable();
+        for (const auto &source : sources)
+            table.addSource(source);
+        table.sort();
+    });
+    printf("Build: %d files (%.1f KB) in %.2f ms (%.1f MB/s): %zu symbols, table %.1f KB\n",
+           table.nbSources(), (double)nbBytes / 1024., buildMs, BenchUtils::MegaBytesPerSecond(nbBytes, buildMs),
+           table.nbSymbols(), (double)table.memoryBytes() / 1024.);
+
+    const int nbLookups = 10000;
+    const std::string &demoCode = sources.back();
+    for (const auto &name : kNames)
+    {
+        std::vector<SymbolTable::Location> locations;
+        double lookupMs = BenchUtils::BestTimeMs(nbIterations, [&] {
+            for (int i = 0; i < nbLookups; ++i)
+                locations = table.find(name);
+        });
+        std::vector<SymbolTable::Usage> usages;
+        double usagesMs = BenchUtils::BestTimeMs(nbIterations, [&] { usages = SymbolTable::FindUsages(demoCode, name); });
+        printf("    %-28s: %2zu locations", name.c_str(), locations.size());
+        if (!locations.empty())
+            printf(" (first: %s %s:%d)", SymbolTable::KindName(locations[0].kind),
+                   kSourcePaths[(size_t)locations[0].fileIndex].c_str(), locations[0].lineNumber + 1);
+        printf("\n        lookup %6.3f us, %4zu usages in imgui_demo.cpp in %6.3f ms\n",
+               lookupMs * 1000. / nbLookups, usages.size(), usagesMs);
+    }
+    return 0;
+}
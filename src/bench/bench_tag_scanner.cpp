@@ -0,0 +1,142 @@
+// Compares the fplus based tag scanners (as they were in Sources.cpp) with the single pass
+// scanners of TagScanner.cpp, on the real imgui.cpp and imgui_demo.cpp.
+//
+// Usage: bench_tag_scanner [nb_iterations]
+#include "BenchUtils.h"
+#include "TagScanner.h"
+#include <fplus/fplus.hpp>
+
+using namespace std::literals;
+using Sources::LinesWithTags;
+
+namespace Legacy
+{
+std::string lowerCaseExceptFirstLetter(const std::string &s)
+{
+    auto r = fplus::to_upper_case(fplus::take(1, s)) +  fplus::to_lower_case(fplus::drop(1, s));
+    return r;
+}
+
+std::string upperCaseQAndA(const std::string &s)
+{
+    if (fplus::take(3, s) == "Q&a")
+        return "Q&A"s + fplus::drop(3, s);
+    else
+        return s;
+}
+
+std::string lowerCaseTitle(const std::string& s)
+{
+    auto words = fplus::split(' ', true, s);
+    words = fplus::transform(lowerCaseExceptFirstLetter, words);
+    auto title = fplus::join(" "s, words);
+    title = upperCaseQAndA(title);
+    return title;
+}
+
+LinesWithTags findImGuiCppDoc(const std::string &sourceCode)
+{
+    LinesWithTags r;
+    /*
+      H1 titles look like this
+      MISSION STATEMENT
+      =================
+      H2 titles look like this
+      READ FIRST
+     ----------
+   */
+    auto lines = fplus::split('\n', true, sourceCode);
+
+    // Given two lines, we can check whether they are a header
+    // and return 0 (not header) , 1 ("H1") or 2 ("H2")
+    auto isHeaderLine = [](const std::pair<std::string, std::string> &linePair) {
+        int r = 0;
+        if (fplus::is_prefix_of("===="s, fplus::trim_whitespace(linePair.second)))
+            r = 1;
+        if (fplus::is_prefix_of("----"s, fplus::trim_whitespace(linePair.second)))
+            r = 2;
+        return r;
+    };
+
+    for (auto idx_lines : fplus::enumerate(fplus::overlapping_pairs(lines)))
+    {
+        int lineNumber = (int)idx_lines.first + 1;
+        auto line_pair = idx_lines.second;
+        int headerWeight = isHeaderLine(line_pair);
+        std::string tag = fplus::trim_whitespace(line_pair.first);
+        tag = lowerCaseTitle(tag);
+        if (headerWeight == 1)
+            r.push_back(Sources::MakeDocLineWithTag(lineNumber, "H1 "s + tag));
+        if (headerWeight == 2)
+            r.push_back(Sources::MakeDocLineWithTag(lineNumber, "H2 "s + tag));
+    }
+    return r;
+}
+
+
+LinesWithTags findImGuiDemoCodeLines(const std::string &sourceCode)
+{
+    LinesWithTags r;
+
+    static std::string regionToken = "DemoCode";
+
+    auto extractDemoCodeName = [](const std::string &codeLine) {
+        // if codeLine == "DemoCode("Line Plots")) {"
+        // then return
+        // "Line Plots"
+        auto tokens = fplus::split('"', true, codeLine);
+        if (tokens.size() >= 3)
+            return tokens[1];
+        else
+            return std::string();
+    };
+
+    auto lines = fplus::split('\n', true, sourceCode);
+    for (size_t line_number = 0; line_number < lines.size(); line_number++)
+    {
+        const std::string& line = lines[line_number];
+        if (line.find(regionToken) != std::string::npos)
+            r.push_back(Sources::MakeLineWithTag((int)line_number + 1, extractDemoCodeName(line)));
+    }
+    return r;
+}
+} // namespace Legacy
+
+
+bool SameTags(const LinesWithTags &a, const LinesWithTags &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].lineNumber != b[i].lineNumber || a[i].tag != b[i].tag || a[i].level != b[i].level)
+            return false;
+    return true;
+}
+
+template <typename LegacyScanner, typename Scanner>
+void BenchScanner(const char *name, const std::string &assetPath, int nbIterations,
+                  LegacyScanner legacyScanner, Scanner scanner)
+{
+    std::string code = BenchUtils::ReadFile(BenchUtils::AssetPath(assetPath));
+
+    LinesWithTags legacyTags, tags;
+    double legacyMs = BenchUtils::BestTimeMs(nbIterations, [&] { legacyTags = legacyScanner(code); });
+    double ms = BenchUtils::BestTimeMs(nbIterations, [&] { tags = scanner(code); });
+
+    printf("%s (%s, %zu bytes, %zu tags)\n", name, assetPath.c_str(), code.size(), tags.size());
+    printf("    fplus scanner      : %8.3f ms  (%7.1f MB/s)\n", legacyMs, BenchUtils::MegaBytesPerSecond(code.size(), legacyMs));
+    printf("    single pass scanner: %8.3f ms  (%7.1f MB/s)\n", ms, BenchUtils::MegaBytesPerSecond(code.size(), ms));
+    printf("    speedup: x%.1f, same tags: %s\n", legacyMs / ms, SameTags(legacyTags, tags) ? "yes" : "NO");
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 20;
+    BenchScanner("ImGuiCppDoc", "code/imgui/imgui.cpp", nbIterations,
+                 [](const std::string &code) { return Legacy::findImGuiCppDoc(code); },
+                 [](const std::string &code) { return Sources::ScanImGuiCppDocTags(code); });
+    BenchScanner("ImGuiDemoCode", "code/imgui/imgui_demo.cpp", nbIterations,
+                 [](const std::string &code) { return Legacy::findImGuiDemoCodeLines(code); },
+                 [](const std::string &code) { return Sources::ScanImGuiDemoCodeTags(code); });
+    return 0;
+}
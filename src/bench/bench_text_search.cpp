@@ -0,0 +1,106 @@
+// Compares the ImGuiTextFilter::PassFilter loop (as guiFind did it) with the TextSearch kernel,
+// on the real imgui.cpp and imgui_demo.cpp. Also checks that EditorSearch gives the same matches
+// (including for an empty filter, which matches every line). Returns 1 if some matches differ.
+//
+// Usage: bench_text_search [nb_iterations]
+#include "BenchUtils.h"
+#include "EditorSearch.h"
+#include "utilities/TextSearch.h"
+#include "imgui.h"
+#include <cstring>
+#include <vector>
+
+std::vector<std::string> SplitLines(const std::string &text)
+{
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+bool gHasDifferentMatches = false;
+
+// EditorSearch::update(text) is what guiFind uses for a LargeFileView
+bool IsSameAsEditorSearch(const std::string &text, const ImGuiTextFilter &imFilter, const std::vector<int> &imMatches)
+{
+    EditorSearch editorSearch;
+    editorSearch.update(text, imFilter);
+    if (editorSearch.nbMatches() != (int)imMatches.size())
+        return false;
+    for (size_t i = 0; i < imMatches.size(); ++i)
+    {
+        if (editorSearch.rankOf(imMatches[i]) != (int)i)
+            return false;
+        int next = (i + 1 < imMatches.size()) ? imMatches[i + 1] : -1;
+        if (editorSearch.nextMatch(imMatches[i]) != next)
+            return false;
+        int previous = (i > 0) ? imMatches[i - 1] : -1;
+        if (editorSearch.previousMatch(imMatches[i]) != previous)
+            return false;
+    }
+    return true;
+}
+
+double LinesPerSecond(size_t nbLines, double ms)
+{
+    return (double)nbLines / (ms / 1000.);
+}
+
+void BenchFilter(const std::string &text, const std::vector<std::string> &lines, const char *filterText, int nbIterations)
+{
+    ImGuiTextFilter imFilter;
+    strncpy(imFilter.InputBuf, filterText, sizeof(imFilter.InputBuf) - 1);
+    imFilter.Build();
+
+    std::vector<int> imMatches, matches;
+    double imMs = BenchUtils::BestTimeMs(nbIterations, [&] {
+        imMatches.clear();
+        for (size_t i = 0; i < lines.size(); ++i)
+            if (imFilter.PassFilter(lines[i].c_str()))
+                imMatches.push_back((int)i);
+    });
+
+    TextSearch::LowercaseDocument document;
+    double buildMs = BenchUtils::BestTimeMs(nbIterations, [&] { document = TextSearch::LowercaseDocument(lines); });
+    TextSearch::Filter filter(filterText);
+    double ms = BenchUtils::BestTimeMs(nbIterations, [&] {
+        matches.clear();
+        filter.findMatchingLines(document, 0, document.nbLines(), &matches);
+    });
+
+    bool isSameAsEditorSearch = IsSameAsEditorSearch(text, imFilter, imMatches);
+    if (matches != imMatches || !isSameAsEditorSearch)
+        gHasDifferentMatches = true;
+    printf("    filter \"%s\": %zu matches, same matches: %s, same as EditorSearch: %s\n",
+           filterText, matches.size(), (matches == imMatches) ? "yes" : "NO", isSameAsEditorSearch ? "yes" : "NO");
+    printf("        PassFilter loop     : %8.3f ms  (%6.1f M lines/s)\n", imMs, LinesPerSecond(lines.size(), imMs) / 1e6);
+    printf("        TextSearch          : %8.3f ms  (%6.1f M lines/s)  x%.1f\n", ms, LinesPerSecond(lines.size(), ms) / 1e6, imMs / ms);
+    printf("        TextSearch + build  : %8.3f ms  (%6.1f M lines/s)  x%.1f\n", ms + buildMs,
+           LinesPerSecond(lines.size(), ms + buildMs) / 1e6, imMs / (ms + buildMs));
+}
+
+void BenchFile(const std::string &assetPath, int nbIterations)
+{
+    std::string text = BenchUtils::ReadFile(BenchUtils::AssetPath(assetPath));
+    std::vector<std::string> lines = SplitLines(text);
+    printf("%s (%zu lines)\n", assetPath.c_str(), lines.size());
+    for (const char *filterText : {"button", "ImGui::Begin", "-widgets,DemoCode", "-;,if", "zzz", "i", ""})
+        BenchFilter(text, lines, filterText, nbIterations);
+}
+
+int main(int argc, char **argv)
+{
+    int nbIterations = (argc > 1) ? atoi(argv[1]) : 20;
+    // ImGuiTextFilter only needs a context for its Draw() method, which is not used here
+    printf("TextSearch implementation: %s\n", TextSearch::FindImplementationName());
+    BenchFile("code/imgui/imgui_demo.cpp", nbIterations);
+    BenchFile("code/imgui/imgui.cpp", nbIterations);
+    return gHasDifferentMatches ? 1 : 0;
+}
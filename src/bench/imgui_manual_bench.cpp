@@ -0,0 +1,354 @@
+// Runs the browsers of the manual in an ImGui context without any window or renderer
+// (so that it can run on a headless CI box), through scripted scenarios: open each
+// library file, type search filters, scroll, jump to tags, stay idle.
+// Reports the frame times, allocations and memory of each scenario as JSON
+// (and the cpu use of the idle_cpu scenarios, which run at the pace of a 60 Hz display).
+//
+// Usage: imgui_manual_bench [output.json]   (default: stdout)
+#include "CodeNavigation.h"
+#include "ImGuiCodeBrowser.h"
+#include "ImGuiCppDocBrowser.h"
+#include "ImGuiDemoBrowser.h"
+#include "Sources.h"
+#include "utilities/AllocationCounter.h"
+#include "utilities/CpuUsage.h"
+#include "utilities/FrameArena.h"
+#include "utilities/IdleThrottle.h"
+#include "utilities/MemoryUsage.h"
+#include "utilities/WorkerPool.h"
+#include "hello_imgui/hello_imgui.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const std::string kDemoCodeLabel = "ImGui - Demo Code";
+    const std::string kCppDocLabel = "ImGui - Doc";
+    const std::string kCodeBrowserLabel = "ImGui - Code";
+
+    constexpr int kMaxFramesUntilIdle = 2000;
+    constexpr int kMaxNbTagJumps = 200;
+    constexpr double kIdleCpuSeconds = 2.;
+
+    struct ScenarioResult
+    {
+        std::string name;
+        std::vector<double> frameMs;
+        uint64_t nbAllocations = 0;
+        uint64_t allocatedBytes = 0;
+        size_t rssBytes = 0;
+        size_t peakRssBytes = 0;
+        double cpuPercent = -1.; // only measured by the idle_cpu scenarios
+    };
+
+    // The windows, as they would be docked: only the visible ones are drawn,
+    // one above the other, over the whole display
+    std::vector<HelloImGui::DockableWindow> gDockableWindows;
+    std::unique_ptr<ImGuiDemoBrowser> gDemoBrowser;
+    std::unique_ptr<ImGuiCppDocBrowser> gCppDocBrowser;
+    std::unique_ptr<ImGuiCodeBrowser> gCodeBrowser;
+
+    void InitImGui()
+    {
+        ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2(1200.f, 800.f);
+        io.Fonts->AddFontDefault();
+        // The font atlas must be built before the first frame, but it is never uploaded
+        unsigned char *pixels = nullptr;
+        int width = 0, height = 0;
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    }
+
+    void InitWindows()
+    {
+        HelloImGui::DockableWindow demoCode;
+        demoCode.label = kDemoCodeLabel;
+        demoCode.GuiFonction = [] { gDemoBrowser->gui(); };
+        HelloImGui::DockableWindow cppDoc;
+        cppDoc.label = kCppDocLabel;
+        cppDoc.GuiFonction = [] { gCppDocBrowser->gui(); };
+        HelloImGui::DockableWindow codeBrowser;
+        codeBrowser.label = kCodeBrowserLabel;
+        codeBrowser.GuiFonction = [] { gCodeBrowser->gui(); };
+        gDockableWindows = {demoCode, cppDoc, codeBrowser};
+
+        // Same as ImGuiManual.cpp
+        CodeNavigation::RegisterSources(kDemoCodeLabel, {"imgui/imgui_demo.cpp"});
+        CodeNavigation::RegisterSources(kCppDocLabel, {"imgui/imgui.cpp"});
+        CodeNavigation::RegisterSources(kCodeBrowserLabel, Sources::librarySourcePaths(Sources::imguiLibrary()));
+    }
+
+    void ShowOnly(const std::string &windowLabel)
+    {
+        for (auto &dockableWindow : gDockableWindows)
+            dockableWindow.isVisible = (dockableWindow.label == windowLabel);
+    }
+
+    // Runs one frame (beforeFrame is included in its time), like HelloImGui's loop,
+    // minus the platform and the renderer
+    void Frame(ScenarioResult *result, const std::function<void()> &beforeFrame = {})
+    {
+        ImGuiIO &io = ImGui::GetIO();
+        io.DeltaTime = 1.f / 60.f;
+        uint64_t nbAllocationsAtStart = AllocationCounter::NbAllocations();
+        uint64_t allocatedBytesAtStart = AllocationCounter::NbAllocatedBytes();
+        auto start = Clock::now();
+
+        if (beforeFrame)
+            beforeFrame();
+        FrameArena::NewFrame();
+        ImGui::NewFrame();
+        // The time waited by the throttle is not part of the frame
+        double waitedMs = IdleThrottle::OnNewFrame();
+        WorkerPool::ProcessFrame(/*timeBudgetMs=*/ 8.);
+        CodeNavigation::ShowRequestedWindow(gDockableWindows);
+        for (auto &dockableWindow : gDockableWindows)
+        {
+            if (!dockableWindow.isVisible)
+                continue;
+            ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+            ImGui::SetNextWindowSize(io.DisplaySize);
+            ImGui::Begin(dockableWindow.label.c_str(), nullptr, dockableWindow.imGuiWindowFlags);
+            dockableWindow.GuiFonction();
+            ImGui::End();
+        }
+        ImGui::Render();
+
+        auto end = Clock::now();
+        result->frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count() - waitedMs);
+        result->nbAllocations += AllocationCounter::NbAllocations() - nbAllocationsAtStart;
+        result->allocatedBytes += AllocationCounter::NbAllocatedBytes() - allocatedBytesAtStart;
+    }
+
+    // Runs frames until the background jobs (loading, colorization) are done
+    void FramesUntilIdle(ScenarioResult *result)
+    {
+        for (int i = 0; i < kMaxFramesUntilIdle && WorkerPool::IsBusy(); ++i)
+            Frame(result);
+        Frame(result);
+    }
+
+    ScenarioResult RunScenario(const std::string &name, const std::function<void(ScenarioResult *)> &scenario)
+    {
+        ScenarioResult result;
+        result.name = name;
+        scenario(&result);
+        result.rssBytes = MemoryUsage::CurrentRssBytes();
+        result.peakRssBytes = MemoryUsage::PeakRssBytes();
+        return result;
+    }
+
+    void Startup(ScenarioResult *result)
+    {
+        ShowOnly(kDemoCodeLabel);
+        Frame(result, [] {
+            gDemoBrowser = std::make_unique<ImGuiDemoBrowser>();
+            gCppDocBrowser = std::make_unique<ImGuiCppDocBrowser>();
+            gCodeBrowser = std::make_unique<ImGuiCodeBrowser>();
+        });
+        FramesUntilIdle(result);
+    }
+
+    void OpenLibraryFiles(ScenarioResult *result)
+    {
+        ShowOnly(kCodeBrowserLabel);
+        for (const auto &sourcePath : Sources::librarySourcePaths(Sources::imguiLibrary()))
+        {
+            // Images need a renderer
+            if (sourcePath.size() > 4 && sourcePath.substr(sourcePath.size() - 4) == ".png")
+                continue;
+            CodeNavigation::RequestShow(sourcePath, 0);
+            Frame(result);
+            FramesUntilIdle(result);
+        }
+    }
+
+    void TypeSearchFilters(ScenarioResult *result)
+    {
+        ShowOnly(kDemoCodeLabel);
+        for (std::string filter : {"ImGui::Button", "-widgets,Checkbox", "TreeNode"})
+        {
+            // One more character per frame
+            for (size_t length = 1; length <= filter.size(); ++length)
+            {
+                gDemoBrowser->setSearchFilter(filter.substr(0, length));
+                Frame(result);
+            }
+            gDemoBrowser->setSearchFilter("");
+            Frame(result);
+        }
+    }
+
+    void Scroll(ScenarioResult *result)
+    {
+        for (const std::string &windowLabel : {kDemoCodeLabel, kCppDocLabel})
+        {
+            ShowOnly(windowLabel);
+            Frame(result);
+            ImGuiIO &io = ImGui::GetIO();
+            // Over the editor, which is at the bottom of the windows
+            io.MousePos = ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.8f);
+            for (int i = 0; i < 240; ++i)
+                Frame(result, [&io, i] { io.MouseWheel = (i < 120) ? -5.f : 5.f; });
+            io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+        }
+    }
+
+    void JumpToTags(ScenarioResult *result)
+    {
+        struct Target
+        {
+            std::string windowLabel;
+            Sources::AnnotatedSource annotatedSource;
+        };
+        std::vector<Target> targets = {
+            {kDemoCodeLabel, Sources::ReadImGuiDemoCode("imgui/imgui_demo.cpp")},
+            {kCppDocLabel, Sources::ReadImGuiCppDoc("imgui/imgui.cpp")}};
+        for (const auto &target : targets)
+        {
+            ShowOnly(target.windowLabel);
+            const auto &linesWithTags = target.annotatedSource.linesWithTags;
+            size_t step = std::max<size_t>(1, linesWithTags.size() / kMaxNbTagJumps);
+            for (size_t i = 0; i < linesWithTags.size(); i += step)
+            {
+                CodeNavigation::RequestShow(target.annotatedSource.source.sourcePath, linesWithTags[i].lineNumber);
+                Frame(result);
+                Frame(result);
+            }
+        }
+    }
+
+    // Nothing happens: once the FrameArena has grown, frames should make no heap allocation
+    void Idle(ScenarioResult *result)
+    {
+        for (const std::string &windowLabel : {kDemoCodeLabel, kCppDocLabel, kCodeBrowserLabel})
+        {
+            ShowOnly(windowLabel);
+            FramesUntilIdle(result);
+            for (int i = 0; i < 60; ++i)
+                Frame(result);
+        }
+    }
+
+    // The demo code stays on screen for a while, with frames paced like a 60 Hz display would
+    void IdleCpu(ScenarioResult *result, bool isThrottled)
+    {
+        ShowOnly(kDemoCodeLabel);
+        FramesUntilIdle(result);
+        IdleThrottle::SetEnabled(isThrottled);
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / 60.));
+        double cpuSecondsAtStart = CpuUsage::ProcessCpuSeconds();
+        auto start = Clock::now();
+        auto nextFrame = start;
+        while (std::chrono::duration<double>(Clock::now() - start).count() < kIdleCpuSeconds)
+        {
+            Frame(result);
+            nextFrame = std::max(nextFrame + period, Clock::now());
+            std::this_thread::sleep_until(nextFrame);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result->cpuPercent = 100. * (CpuUsage::ProcessCpuSeconds() - cpuSecondsAtStart) / seconds;
+        IdleThrottle::SetEnabled(false);
+    }
+
+    void IdleCpuUnthrottled(ScenarioResult *result)
+    {
+        IdleCpu(result, false);
+    }
+
+    void IdleCpuThrottled(ScenarioResult *result)
+    {
+        IdleCpu(result, true);
+    }
+
+    double Percentile(std::vector<double> sortedValues, double percent)
+    {
+        if (sortedValues.empty())
+            return 0.;
+        return sortedValues[(size_t)(percent / 100. * (double)(sortedValues.size() - 1) + 0.5)];
+    }
+
+    void WriteJson(FILE *f, const std::vector<ScenarioResult> &results)
+    {
+        fprintf(f, "{\n  \"scenarios\": [\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            std::vector<double> sortedMs = r.frameMs;
+            std::sort(sortedMs.begin(), sortedMs.end());
+            double totalMs = 0.;
+            for (double ms : sortedMs)
+                totalMs += ms;
+            size_t nbFrames = sortedMs.size();
+            fprintf(f, "    {\"name\": \"%s\", \"frames\": %zu, \"total_ms\": %.3f, \"mean_ms\": %.3f, "
+                       "\"p50_ms\": %.3f, \"p95_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f, "
+                       "\"allocations\": %llu, \"allocated_bytes\": %llu, \"allocations_per_frame\": %.1f, "
+                       "\"rss_bytes\": %zu, \"peak_rss_bytes\": %zu, \"cpu_percent\": %.1f}%s\n",
+                    r.name.c_str(), nbFrames, totalMs, nbFrames > 0 ? totalMs / (double)nbFrames : 0.,
+                    Percentile(sortedMs, 50.), Percentile(sortedMs, 95.), Percentile(sortedMs, 99.),
+                    nbFrames > 0 ? sortedMs.back() : 0.,
+                    (unsigned long long)r.nbAllocations, (unsigned long long)r.allocatedBytes,
+                    nbFrames > 0 ? (double)r.nbAllocations / (double)nbFrames : 0.,
+                    r.rssBytes, r.peakRssBytes, r.cpuPercent, (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(f, "  ],\n  \"peak_rss_bytes\": %zu\n}\n", MemoryUsage::PeakRssBytes());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    HelloImGui::overrideAssetsFolder(IMGUI_MANUAL_ASSETS_DIR);
+    InitImGui();
+    InitWindows();
+    // The scenarios measure the frames as fast as they run (except idle_cpu_throttled)
+    IdleThrottle::SetEnabled(false);
+
+    std::vector<ScenarioResult> results;
+    results.push_back(RunScenario("startup", Startup));
+    results.push_back(RunScenario("open_library_files", OpenLibraryFiles));
+    results.push_back(RunScenario("type_search_filters", TypeSearchFilters));
+    results.push_back(RunScenario("scroll", Scroll));
+    results.push_back(RunScenario("jump_to_tags", JumpToTags));
+    results.push_back(RunScenario("idle", Idle));
+    results.push_back(RunScenario("idle_cpu_unthrottled", IdleCpuUnthrottled));
+    results.push_back(RunScenario("idle_cpu_throttled", IdleCpuThrottled));
+
+    for (const auto &r : results)
+    {
+        double totalMs = 0.;
+        for (double ms : r.frameMs)
+            totalMs += ms;
+        fprintf(stderr, "%-24s %5zu frames %10.1f ms %12llu allocations", r.name.c_str(), r.frameMs.size(),
+                totalMs, (unsigned long long)r.nbAllocations);
+        if (r.cpuPercent >= 0.)
+            fprintf(stderr, " %6.1f%% cpu", r.cpuPercent);
+        fprintf(stderr, "\n");
+    }
+
+    FILE *f = (argc > 1) ? fopen(argv[1], "w") : stdout;
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Cannot write %s\n", argv[1]);
+        return 1;
+    }
+    WriteJson(f, results);
+    if (f != stdout)
+        fclose(f);
+
+    gCodeBrowser.reset();
+    gCppDocBrowser.reset();
+    gDemoBrowser.reset();
+    ImGui::DestroyContext();
+    return 0;
+}
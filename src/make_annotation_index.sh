@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# Writes the annotation index of a source file (i.e. its tags) into "$source_file.tags"
+# so that Sources::ReadImGuiDemoCode / ReadImGuiCppDoc do not have to scan it at runtime.
+#
+# Usage: make_annotation_index.sh demo|doc source_file
+#
+# Format (keep in sync with AnnotationIndex.cpp):
+#     # imgui_manual annotation index v1
+#     cksum <crc> <size>              <- output of "cksum source_file"
+#     <line number><TAB><tag>         <- one line per tag
+#
+# The tags are computed exactly as in TagScanner.cpp (which is used when the index is missing or stale)
+
+kind=$1
+source_file=$2
+index_file=$source_file.tags
+
+if [ ! -f "$source_file" ]; then
+  echo "make_annotation_index.sh: $source_file not found"
+  exit 1
+fi
+
+export LC_ALL=C
+read -r crc size _ < <(cksum "$source_file")
+{
+  echo "# imgui_manual annotation index v1"
+  echo "cksum $crc $size"
+
+  if [ "$kind" == "demo" ]; then
+    # DemoCode("Line Plots")) {   =>   Line Plots
+    awk '
+      index($0, "DemoCode") > 0 {
+        tag = ""
+        q1 = index($0, "\"")
+        if (q1 > 0) {
+          rest = substr($0, q1 + 1)
+          q2 = index(rest, "\"")
+          if (q2 > 0)
+            tag = substr(rest, 1, q2 - 1)
+        }
+        printf "%d\t%s\n", NR, tag
+      }
+    ' "$source_file"
+  elif [ "$kind" == "doc" ]; then
+    # MISSION STATEMENT      =>   H1 Mission Statement
+    # =================
+    awk '
+      function titlecase(s,    r, i, c, prevc) {
+        r = ""
+        prevc = " "
+        for (i = 1; i <= length(s); i++) {
+          c = substr(s, i, 1)
+          r = r ((prevc == " ") ? toupper(c) : tolower(c))
+          prevc = c
+        }
+        if (substr(r, 1, 3) == "Q&a")
+          r = "Q&A" substr(r, 4)
+        return r
+      }
+      {
+        if (NR > 1) {
+          underline = $0
+          sub(/^[ \t\r\n]+/, "", underline)
+          prefix = ""
+          if (substr(underline, 1, 4) == "====")
+            prefix = "H1 "
+          else if (substr(underline, 1, 4) == "----")
+            prefix = "H2 "
+          if (prefix != "") {
+            title = previous
+            sub(/^[ \t\r\n]+/, "", title)
+            sub(/[ \t\r\n]+$/, "", title)
+            printf "%d\t%s%s\n", NR - 1, prefix, titlecase(title)
+          }
+        }
+        previous = $0
+      }
+    ' "$source_file"
+  else
+    echo "make_annotation_index.sh: unknown kind $kind" >&2
+    exit 1
+  fi
+} > "$index_file"
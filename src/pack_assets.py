@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Packs the code assets into a single compressed archive: output_dir/code.pack
+
+populate_assets.sh copies whole directories into assets/code, but the manual only shows the files
+listed by the libraries of Sources.cpp. This script builds its manifest from those lists
+(plus the annotation indexes), and packs only these files into output_dir, so that the emscripten payload
+is smaller. Images are not packed: they are copied into output_dir/code
+(including the local images of the markdown files, which ImageService reads).
+assets/code is only read: src/CMakeLists.txt runs this script at build time, into the build directory.
+
+Usage: pack_assets.py path/to/Sources.cpp path/to/assets/code path/to/output_dir
+
+Format of code.pack (keep in sync with AssetPack.cpp), all integers are little endian:
+    "IMGUIPAK"                                  <- magic (8 bytes)
+    u32 version (1), u32 nbEntries
+    nbEntries * (u16 pathSize, path, u32 offset, u32 compressedSize, u32 size)
+    the compressed files                        <- offsets are from the start of code.pack
+Each file is compressed as one LZ4 block (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+"""
+import os
+import re
+import shutil
+import struct
+import sys
+
+PACK_MAGIC = b"IMGUIPAK"
+PACK_VERSION = 1
+IMAGE_EXTENSIONS = (".png", ".jpg", ".jpeg", ".gif", ".bmp")
+# Sources that are read with their annotation index (see make_annotation_index.sh)
+ANNOTATED_SOURCES = ["imgui/imgui_demo.cpp", "imgui/imgui.cpp"]
+
+# A markdown image: ![alt](path)
+MARKDOWN_IMAGE_REGEX = re.compile(r"!\[[^\]]*\]\(([^)\s]+)\)")
+
+# LZ4 block format constants
+MIN_MATCH = 4
+LAST_LITERALS = 5  # the last 5 bytes are always literals
+MATCH_FIND_LIMIT = 12  # the last match starts at least 12 bytes before the end
+MAX_OFFSET = 65535
+
+
+def library_source_paths(sources_cpp_code):
+    """The paths of the files listed by the libraries of Sources.cpp, e.g. "imgui/imgui.h"
+    A library looks like: { "path", "name", "url", "doc", make_string_vec(R"( files )") }"""
+    library_regex = re.compile(r'\{\s*"([^"]+)"\s*,[^{}]*?make_string_vec\(R"\((.*?)\)"\)', re.DOTALL)
+    r = []
+    for library_path, files in library_regex.findall(sources_cpp_code):
+        for file in files.split("\n"):
+            file = file.strip()
+            if file:
+                r.append(library_path + "/" + file)
+    return r
+
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, offset, match_length):
+    nb_literals = len(literals)
+    extra_match_length = match_length - MIN_MATCH
+    out.append((min(nb_literals, 15) << 4) | min(extra_match_length, 15))
+    if nb_literals >= 15:
+        write_length(out, nb_literals - 15)
+    out += literals
+    out += struct.pack("<H", offset)
+    if extra_match_length >= 15:
+        write_length(out, extra_match_length - 15)
+
+
+def write_last_literals(out, literals):
+    nb_literals = len(literals)
+    out.append(min(nb_literals, 15) << 4)
+    if nb_literals >= 15:
+        write_length(out, nb_literals - 15)
+    out += literals
+
+
+def lz4_compress_block(data):
+    """Greedy LZ4 block compression: the last position of each 4 bytes sequence is remembered"""
+    out = bytearray()
+    last_position_of = {}
+    anchor = 0  # start of the pending literals
+    i = 0
+    match_start_limit = len(data) - MATCH_FIND_LIMIT
+    while i < match_start_limit:
+        key = data[i:i + MIN_MATCH]
+        candidate = last_position_of.get(key, -1)
+        last_position_of[key] = i
+        if candidate < 0 or i - candidate > MAX_OFFSET:
+            i += 1
+            continue
+        match_length = MIN_MATCH
+        max_match_length = len(data) - LAST_LITERALS - i
+        while match_length < max_match_length and data[candidate + match_length] == data[i + match_length]:
+            match_length += 1
+        write_sequence(out, data[anchor:i], i - candidate, match_length)
+        i += match_length
+        anchor = i
+    write_last_literals(out, data[anchor:])
+    return bytes(out)
+
+
+def write_pack(pack_path, files):
+    """files: list of (path, data)"""
+    compressed_files = [(path, data, lz4_compress_block(data)) for path, data in files]
+    header_size = len(PACK_MAGIC) + 8
+    for path, _, _ in compressed_files:
+        header_size += 2 + len(path.encode("utf-8")) + 12
+    header = bytearray(PACK_MAGIC)
+    header += struct.pack("<II", PACK_VERSION, len(compressed_files))
+    offset = header_size
+    for path, data, compressed in compressed_files:
+        path_bytes = path.encode("utf-8")
+        header += struct.pack("<H", len(path_bytes)) + path_bytes
+        header += struct.pack("<III", offset, len(compressed), len(data))
+        offset += len(compressed)
+    with open(pack_path, "wb") as f:
+        f.write(header)
+        for _, _, compressed in compressed_files:
+            f.write(compressed)
+
+
+def directory_size(directory):
+    r = 0
+    for root, _, files in os.walk(directory):
+        for file in files:
+            r += os.path.getsize(os.path.join(root, file))
+    return r
+
+
+def markdown_image_paths(md_path, md_code):
+    """The local images of a markdown file, as paths relative to assets/code (web images are skipped)"""
+    md_dir = os.path.dirname(md_path)
+    r = []
+    for link in MARKDOWN_IMAGE_REGEX.findall(md_code):
+        if "://" not in link:
+            r.append(os.path.normpath(os.path.join(md_dir, link)).replace(os.sep, "/"))
+    return r
+
+
+def main():
+    if len(sys.argv) != 4:
+        print("Usage: pack_assets.py path/to/Sources.cpp path/to/assets/code path/to/output_dir")
+        return 1
+    sources_cpp, code_dir, output_dir = sys.argv[1], sys.argv[2], sys.argv[3]
+    pack_path = os.path.join(output_dir, "code.pack")
+    output_code_dir = os.path.join(output_dir, "code")
+
+    with open(sources_cpp, encoding="utf-8") as f:
+        manifest = library_source_paths(f.read())
+    manifest += ANNOTATED_SOURCES
+    manifest += [path + ".tags" for path in ANNOTATED_SOURCES]
+    manifest = sorted(set(manifest))
+
+    nb_bytes_before = directory_size(code_dir)
+    packed_files, images = [], []
+    for path in manifest:
+        full_path = os.path.join(code_dir, path)
+        if not os.path.isfile(full_path):
+            print("pack_assets.py: {} not found, it is not packed".format(full_path))
+            continue
+        if path.lower().endswith(IMAGE_EXTENSIONS):
+            images.append(path)
+            continue
+        with open(full_path, "rb") as f:
+            packed_files.append((path, f.read()))
+        if path.lower().endswith(".md"):
+            md_code = packed_files[-1][1].decode("utf-8", errors="replace")
+            for image_path in markdown_image_paths(path, md_code):
+                if os.path.isfile(os.path.join(code_dir, image_path)) and image_path not in images:
+                    images.append(image_path)
+    os.makedirs(output_dir, exist_ok=True)
+    write_pack(pack_path, packed_files)
+
+    # Only the images are copied into output_dir/code (the images of a previous run are removed)
+    if os.path.isdir(output_code_dir):
+        shutil.rmtree(output_code_dir)
+    for path in images:
+        os.makedirs(os.path.dirname(os.path.join(output_code_dir, path)), exist_ok=True)
+        shutil.copyfile(os.path.join(code_dir, path), os.path.join(output_code_dir, path))
+
+    nb_bytes_after = os.path.getsize(pack_path) + directory_size(output_code_dir)
+    print("pack_assets.py: packed {} files into {} (+ {} images)".format(len(packed_files), pack_path, len(images)))
+    print("pack_assets.py: code assets {} bytes before, {} bytes after ({:.1f}%)".format(
+        nb_bytes_before, nb_bytes_after, 100. * nb_bytes_after / max(nb_bytes_before, 1)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -23,6 +23,9 @@ cd imgui_manual
 cp -f $SRC_DIR/* .
 cp -f $SRC_DIR/../Readme.md .
 cp -f $SRC_DIR/../LICENSE .
+# The images of Readme.md
+mkdir -p doc/images
+cp -f $SRC_DIR/../doc/images/* doc/images/
 cd ..
 
 if [ ! -d ImGuiColorTextEdit ]; then
@@ -70,3 +73,8 @@ cp $fplus_dir/*.md .
 cp $fplus_dir/LICENSE .
 cp $fplus_dir/include/fplus/fplus.hpp .
 cd ..
+
+# Annotation indexes, so that the tags are not recomputed at each launch
+# (see make_annotation_index.sh)
+$SRC_DIR/make_annotation_index.sh demo imgui/imgui_demo.cpp
+$SRC_DIR/make_annotation_index.sh doc imgui/imgui.cpp
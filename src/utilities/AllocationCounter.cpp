@@ -0,0 +1,49 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // Plain counters, since they are per thread
+    thread_local uint64_t tNbAllocations = 0;
+    thread_local uint64_t tNbAllocatedBytes = 0;
+}
+
+// The other forms of operator new / delete (array, nothrow) call these by default.
+// They are alone in this file, so that the compiler does not see malloc / free
+// where it expects new / delete.
+void *operator new(std::size_t size)
+{
+    ++tNbAllocations;
+    tNbAllocatedBytes += size;
+    if (void *p = std::malloc(size > 0 ? size : 1))
+        return p;
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace AllocationCounter
+{
+    uint64_t NbAllocations()
+    {
+        return tNbAllocations;
+    }
+
+    uint64_t NbAllocatedBytes()
+    {
+        return tNbAllocatedBytes;
+    }
+}
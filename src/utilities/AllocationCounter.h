@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Counts the heap allocations of each thread, through the replacement of the global
+// operator new in AllocationCounter.cpp (used by the Profiler)
+namespace AllocationCounter
+{
+    // The allocations made by the current thread since it started
+    uint64_t NbAllocations();
+    uint64_t NbAllocatedBytes();
+}
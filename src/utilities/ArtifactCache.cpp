@@ -0,0 +1,308 @@
+#include "ArtifactCache.h"
+#include "CacheDir.h"
+#include "Checksum.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+// The version of the manual (see src/CMakeLists.txt): artifacts made by another version are stale
+#ifndef IMGUI_MANUAL_VERSION
+#define IMGUI_MANUAL_VERSION "dev"
+#endif
+
+namespace ArtifactCache
+{
+    namespace
+    {
+        namespace fs = std::filesystem;
+        using Clock = std::chrono::steady_clock;
+
+        /*
+         Format of an artifact file, named "<kind>_<contentCksum>_<contentSize>.bin"
+             "IMARTIFC", u32 kFileFormatVersion
+             u32 formatVersion (of the kind), u32 cksum of IMGUI_MANUAL_VERSION
+             u32 contentSize, u32 contentCksum
+             u32 payloadSize, u32 payloadCksum
+             u8 payload[payloadSize]
+        */
+        constexpr std::string_view kMagic = "IMARTIFC";
+        constexpr uint32_t kFileFormatVersion = 1;
+
+        struct Header
+        {
+            uint32_t fileFormatVersion;
+            uint32_t formatVersion, appVersionCksum;
+            uint32_t contentSize, contentCksum;
+            uint32_t payloadSize, payloadCksum;
+        };
+
+#ifdef __EMSCRIPTEN__
+        size_t gByteBudget = 32 * 1024 * 1024;
+#else
+        size_t gByteBudget = 64 * 1024 * 1024;
+#endif
+
+        // Protects the globals, and serializes the writes into the directory
+        std::mutex gMutex;
+        Stats gStats;
+
+        uint32_t AppVersionCksum()
+        {
+            static const uint32_t cksum = [] {
+                std::string_view version = IMGUI_MANUAL_VERSION;
+                return Checksum::PosixCksum(version.data(), version.size());
+            }();
+            return cksum;
+        }
+
+        // Returns "" if there is no cache directory
+        std::string ArtifactsDir()
+        {
+            std::string cacheDir = CacheDir::Path();
+            if (cacheDir.empty())
+                return "";
+            std::string dir = cacheDir + "/artifacts";
+            std::error_code error;
+            fs::create_directories(dir, error);
+            return fs::is_directory(dir, error) ? dir : "";
+        }
+
+        std::string FilePath(const std::string &dir, const Key &key)
+        {
+            char suffix[32];
+            snprintf(suffix, sizeof(suffix), "_%08x_%u.bin", key.contentCksum, key.contentSize);
+            return dir + "/" + key.kind + suffix;
+        }
+
+        bool ReadFile(const std::string &path, std::string *content)
+        {
+            FILE *f = fopen(path.c_str(), "rb");
+            if (f == nullptr)
+                return false;
+            char buffer[65536];
+            size_t nbRead;
+            while ((nbRead = fread(buffer, 1, sizeof(buffer), f)) > 0)
+                content->append(buffer, nbRead);
+            bool ok = (ferror(f) == 0);
+            fclose(f);
+            return ok;
+        }
+
+        // Writes into a temporary file, renamed at the end: a concurrent launch never reads half a file
+        bool WriteFile(const std::string &path, std::string_view header, std::string_view payload)
+        {
+            std::string tmpPath = path + ".tmp";
+            FILE *f = fopen(tmpPath.c_str(), "wb");
+            if (f == nullptr)
+                return false;
+            bool ok = (fwrite(header.data(), 1, header.size(), f) == header.size())
+                      && (fwrite(payload.data(), 1, payload.size(), f) == payload.size());
+            if (fclose(f) != 0)
+                ok = false;
+            if (ok)
+                ok = (rename(tmpPath.c_str(), path.c_str()) == 0);
+            if (!ok)
+                remove(tmpPath.c_str());
+            return ok;
+        }
+
+        // Returns the payload inside the file content, or false if the file does not match key
+        bool CheckFile(std::string_view content, const Key &key, std::string_view *payload)
+        {
+            if (content.size() < kMagic.size() + sizeof(Header) || content.substr(0, kMagic.size()) != kMagic)
+                return false;
+            Header header;
+            memcpy(&header, content.data() + kMagic.size(), sizeof(Header));
+            *payload = content.substr(kMagic.size() + sizeof(Header));
+            return header.fileFormatVersion == kFileFormatVersion
+                   && header.formatVersion == key.formatVersion
+                   && header.appVersionCksum == AppVersionCksum()
+                   && header.contentSize == key.contentSize
+                   && header.contentCksum == key.contentCksum
+                   && header.payloadSize == payload->size()
+                   && header.payloadCksum == Checksum::PosixCksum(payload->data(), payload->size());
+        }
+
+        // Removes the least recently used files, until the directory fits within the budget.
+        // Call with gMutex locked
+        void EvictIfNeeded(const std::string &dir)
+        {
+            struct File
+            {
+                fs::path path;
+                uintmax_t nbBytes;
+                fs::file_time_type lastUse;
+            };
+            std::vector<File> files;
+            size_t nbBytes = 0;
+            std::error_code error;
+            for (const auto &entry : fs::directory_iterator(dir, error))
+            {
+                if (!entry.is_regular_file(error) || entry.path().extension() != ".bin")
+                    continue;
+                File file{entry.path(), entry.file_size(error), entry.last_write_time(error)};
+                if (error)
+                    continue;
+                nbBytes += (size_t)file.nbBytes;
+                files.push_back(file);
+            }
+            std::sort(files.begin(), files.end(), [](const File &a, const File &b) { return a.lastUse < b.lastUse; });
+            size_t nbEvicted = 0;
+            while (nbBytes > gByteBudget && nbEvicted < files.size())
+            {
+                const File &file = files[nbEvicted++];
+                fs::remove(file.path, error);
+                nbBytes -= (size_t)file.nbBytes;
+                gStats.nbEvictions++;
+            }
+            gStats.nbFiles = (int)(files.size() - nbEvicted);
+            gStats.nbBytes = nbBytes;
+        }
+
+        double MsSince(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+    } // namespace
+
+    Key MakeKey(std::string_view kind, uint32_t formatVersion, std::string_view content)
+    {
+        return Key{std::string(kind), formatVersion, (uint32_t)content.size(),
+                   Checksum::PosixCksum(content.data(), content.size())};
+    }
+
+    bool Load(const Key &key, std::string *payload)
+    {
+        auto start = Clock::now();
+        std::string dir = ArtifactsDir();
+        std::string path = dir.empty() ? "" : FilePath(dir, key);
+        std::string content;
+        bool isFound = !path.empty() && ReadFile(path, &content);
+        std::string_view payloadView;
+        bool isValid = isFound && CheckFile(content, key, &payloadView);
+        std::error_code error;
+        if (isValid)
+        {
+            payload->assign(payloadView.data(), payloadView.size());
+            // The modification time is the time of the last use (see EvictIfNeeded)
+            fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+        }
+        else if (isFound)
+            fs::remove(path, error);
+
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (isValid)
+            gStats.nbHits++;
+        else
+            gStats.nbMisses++;
+        if (isFound && !isValid)
+        {
+            gStats.nbCorrupted++;
+            fprintf(stderr, "ArtifactCache: removed the stale or corrupted %s\n", path.c_str());
+        }
+        gStats.loadMs += MsSince(start);
+        return isValid;
+    }
+
+    void Store(const Key &key, std::string_view payload)
+    {
+        auto start = Clock::now();
+        std::string dir = ArtifactsDir();
+        if (dir.empty())
+            return;
+        Header header{kFileFormatVersion,
+                      key.formatVersion, AppVersionCksum(),
+                      key.contentSize, key.contentCksum,
+                      (uint32_t)payload.size(), Checksum::PosixCksum(payload.data(), payload.size())};
+        std::string headerBytes(kMagic);
+        headerBytes.append((const char *)&header, sizeof(header));
+
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (!WriteFile(FilePath(dir, key), headerBytes, payload))
+            return;
+        gStats.nbStores++;
+        EvictIfNeeded(dir);
+        CacheDir::Flush();
+        gStats.storeMs += MsSince(start);
+    }
+
+    void Clear()
+    {
+        std::string dir = ArtifactsDir();
+        if (dir.empty())
+            return;
+        std::lock_guard<std::mutex> lock(gMutex);
+        std::error_code error;
+        for (const auto &entry : fs::directory_iterator(dir, error))
+            fs::remove(entry.path(), error);
+        gStats.nbFiles = 0;
+        gStats.nbBytes = 0;
+        CacheDir::Flush();
+    }
+
+    void SetByteBudget(size_t nbBytes)
+    {
+        std::string dir = ArtifactsDir();
+        std::lock_guard<std::mutex> lock(gMutex);
+        gByteBudget = nbBytes;
+        if (!dir.empty())
+            EvictIfNeeded(dir);
+    }
+
+    size_t GetByteBudget()
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        return gByteBudget;
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        return gStats;
+    }
+
+    void Writer::writeVarUint(uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            mBytes.push_back((char)((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        mBytes.push_back((char)value);
+    }
+
+    void Writer::writeString(std::string_view s)
+    {
+        writeVarUint((uint32_t)s.size());
+        mBytes.append(s.data(), s.size());
+    }
+
+    bool Reader::readVarUint(uint32_t *value)
+    {
+        *value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (mBytes.empty())
+                return false;
+            unsigned char byte = (unsigned char)mBytes.front();
+            mBytes.remove_prefix(1);
+            *value |= (uint32_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool Reader::readString(std::string_view *s)
+    {
+        uint32_t size;
+        if (!readVarUint(&size) || size > mBytes.size())
+            return false;
+        *s = mBytes.substr(0, size);
+        mBytes.remove_prefix(size);
+        return true;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// ArtifactCache keeps, between launches, what the manual derives from its assets
+// (e.g. the tags of imgui.cpp, or the colorizer tokens of its lines), so that an unchanged asset
+// is not parsed again at the next launch.
+// - an artifact is keyed by its kind, and by the size and cksum of the content it was derived from
+// - each file has a header (magic, format version of the kind, version of the manual, key, and the
+//   size and cksum of its payload): stale, truncated or corrupted files are ignored and removed
+// - the files stay within a byte budget, by removing those that were used the least recently
+//   (a file is touched each time it is loaded)
+// The files are stored in CacheDir::Path() + "/artifacts" (with emscripten, it is backed by IndexedDB).
+// Load() and Store() may be called from any thread (e.g. from the WorkerPool jobs).
+namespace ArtifactCache
+{
+    struct Key
+    {
+        std::string kind;       // e.g. "colorizer_tokens": also the prefix of the file name
+        uint32_t formatVersion; // bump it when the producer of the artifact, or its payload, changes
+        uint32_t contentSize;
+        uint32_t contentCksum;
+    };
+    // Computes the cksum of content (e.g. ~1 ms for imgui.cpp): compute it once for a Load() and a Store()
+    Key MakeKey(std::string_view kind, uint32_t formatVersion, std::string_view content);
+
+    // Returns true if the artifact of key was found, and is valid
+    bool Load(const Key &key, std::string *payload);
+    void Store(const Key &key, std::string_view payload);
+    // Removes all the artifacts
+    void Clear();
+
+    void SetByteBudget(size_t nbBytes);
+    size_t GetByteBudget();
+
+    struct Stats
+    {
+        int nbHits = 0;
+        int nbMisses = 0;
+        int nbCorrupted = 0; // or stale: they count as misses too
+        int nbStores = 0;
+        int nbEvictions = 0;
+        int nbFiles = 0;     // as of the last Store() or Clear()
+        size_t nbBytes = 0;
+        double loadMs = 0.;  // total time spent in Load() and Store()
+        double storeMs = 0.;
+    };
+    Stats GetStats();
+
+    // Helpers to encode the payloads (native endianness: a cache is only read by the same build)
+    class Writer
+    {
+    public:
+        template <typename T>
+        void write(const T &value) { mBytes.append((const char *)&value, sizeof(T)); }
+        void writeVarUint(uint32_t value);
+        void writeString(std::string_view s);
+        const std::string &bytes() const { return mBytes; }
+
+    private:
+        std::string mBytes;
+    };
+
+    // Reads a payload with bounds checks: each read returns false past its end
+    class Reader
+    {
+    public:
+        explicit Reader(std::string_view bytes) : mBytes(bytes) {}
+        template <typename T>
+        bool read(T *value)
+        {
+            if (mBytes.size() < sizeof(T))
+                return false;
+            memcpy(value, mBytes.data(), sizeof(T));
+            mBytes.remove_prefix(sizeof(T));
+            return true;
+        }
+        bool readVarUint(uint32_t *value);
+        bool readString(std::string_view *s);
+        bool isAtEnd() const { return mBytes.empty(); }
+
+    private:
+        std::string_view mBytes;
+    };
+}
@@ -0,0 +1,110 @@
+#include "CacheDir.h"
+#include <cstdlib>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#else
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#endif
+
+namespace CacheDir
+{
+#if defined(__EMSCRIPTEN__)
+    namespace
+    {
+        // IDBFS is mounted there, and loaded before main() runs, by CacheDir.pre.js
+        // (see -lidbfs.js and --pre-js in src/CMakeLists.txt)
+        constexpr const char *kMountPath = "/imgui_manual_cache";
+
+        bool gIsFlushing = false;
+        bool gNeedsFlush = false;
+
+        bool IsLoaded()
+        {
+            static bool isLoaded = EM_ASM_INT({ return Module["imguiManualCacheIsLoaded"] ? 1 : 0; }) != 0;
+            return isLoaded;
+        }
+    }
+
+    std::string Path()
+    {
+        return IsLoaded() ? kMountPath : "";
+    }
+
+    void Flush()
+    {
+        if (!IsLoaded())
+            return;
+        // One sync at a time: the writes made during a sync are persisted by the next one
+        if (gIsFlushing)
+        {
+            gNeedsFlush = true;
+            return;
+        }
+        gIsFlushing = true;
+        EM_ASM({
+            FS.syncfs(false, function(error) { _CacheDir_OnFlushed(); });
+        });
+    }
+#else
+    namespace
+    {
+        bool MakeDir(const std::string &path)
+        {
+            if (path.empty())
+                return false;
+#ifdef _WIN32
+            _mkdir(path.c_str());
+#else
+            mkdir(path.c_str(), 0755);
+#endif
+            struct stat st;
+            return stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFDIR);
+        }
+
+        std::string ComputePath()
+        {
+            std::string baseDir;
+            if (const char *xdgCacheHome = getenv("XDG_CACHE_HOME"))
+                baseDir = xdgCacheHome;
+#ifdef _WIN32
+            else if (const char *localAppData = getenv("LOCALAPPDATA"))
+                baseDir = localAppData;
+#else
+            else if (const char *home = getenv("HOME"))
+                baseDir = std::string(home) + "/.cache";
+#endif
+            if (!MakeDir(baseDir))
+                return "";
+            std::string path = baseDir + "/imgui_manual";
+            return MakeDir(path) ? path : "";
+        }
+    }
+
+    std::string Path()
+    {
+        static std::string path = ComputePath();
+        return path;
+    }
+
+    void Flush()
+    {
+    }
+#endif
+}
+
+#if defined(__EMSCRIPTEN__)
+// Called by FS.syncfs
+extern "C" EMSCRIPTEN_KEEPALIVE void CacheDir_OnFlushed()
+{
+    CacheDir::gIsFlushing = false;
+    if (CacheDir::gNeedsFlush)
+    {
+        CacheDir::gNeedsFlush = false;
+        CacheDir::Flush();
+    }
+}
+#endif
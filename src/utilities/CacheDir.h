@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+
+// The directory where the manual may cache data between launches
+// ($XDG_CACHE_HOME/imgui_manual, or ~/.cache/imgui_manual).
+// With emscripten, it is a directory of the emscripten FS backed by IndexedDB (IDBFS).
+namespace CacheDir
+{
+    // Returns the cache directory (created if needed), or "" if there is none.
+    // With emscripten, the files are loaded from IndexedDB before main() runs (see CacheDir.pre.js):
+    // it is "" if IndexedDB is not available
+    std::string Path();
+    // Persists what was written into the cache directory (with emscripten, into IndexedDB);
+    // does nothing on the other platforms, where the files are persistent already
+    void Flush();
+}
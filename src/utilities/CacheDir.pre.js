@@ -0,0 +1,22 @@
+// Linked with --pre-js (see src/CMakeLists.txt): before main() runs, mounts the cache directory
+// of CacheDir.cpp with IDBFS, and loads its files from IndexedDB.
+// CacheDir::Path() is then ready from the first frame, e.g. for the font atlas and the artifacts.
+Module["preRun"] = Module["preRun"] || [];
+Module["preRun"].push(function() {
+    // Keep in sync with kMountPath in CacheDir.cpp
+    var path = "/imgui_manual_cache";
+    Module["imguiManualCacheIsLoaded"] = false;
+    try {
+        FS.mkdir(path);
+        FS.mount(IDBFS, {}, path);
+    } catch (e) {
+        return;
+    }
+    // main() waits for the run dependencies
+    addRunDependency("imgui_manual_cache");
+    FS.syncfs(true, function(error) {
+        // If IndexedDB is not available (e.g. private browsing), the manual runs without cache
+        Module["imguiManualCacheIsLoaded"] = !error;
+        removeRunDependency("imgui_manual_cache");
+    });
+});
@@ -0,0 +1,54 @@
+#include "Checksum.h"
+
+namespace Checksum
+{
+    namespace
+    {
+        // values[k][i]: the crc of byte i followed by k zero bytes, so that the loop below
+        // consumes 8 bytes per step (the "slicing by 8" method)
+        struct CrcTables
+        {
+            uint32_t values[8][256];
+            CrcTables()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t c = i << 24;
+                    for (int bit = 0; bit < 8; ++bit)
+                        c = (c & 0x80000000u) ? (c << 1) ^ 0x04C11DB7u : (c << 1);
+                    values[0][i] = c;
+                }
+                for (int k = 1; k < 8; ++k)
+                    for (uint32_t i = 0; i < 256; ++i)
+                        values[k][i] = (values[k - 1][i] << 8) ^ values[0][values[k - 1][i] >> 24];
+            }
+        };
+
+        uint32_t BigEndian32(const unsigned char *bytes)
+        {
+            return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+        }
+    }
+
+    uint32_t PosixCksum(const void *data, size_t size)
+    {
+        static const CrcTables tables;
+        const auto &t = tables.values;
+        uint32_t crc = 0;
+        const unsigned char *bytes = (const unsigned char *)data;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint32_t high = crc ^ BigEndian32(bytes + i);
+            uint32_t low = BigEndian32(bytes + i + 4);
+            crc = t[7][high >> 24] ^ t[6][(high >> 16) & 0xFF] ^ t[5][(high >> 8) & 0xFF] ^ t[4][high & 0xFF]
+                  ^ t[3][low >> 24] ^ t[2][(low >> 16) & 0xFF] ^ t[1][(low >> 8) & 0xFF] ^ t[0][low & 0xFF];
+        }
+        for (; i < size; ++i)
+            crc = (crc << 8) ^ t[0][(crc >> 24) ^ bytes[i]];
+        // cksum then hashes the length, least significant byte first
+        for (size_t length = size; length != 0; length >>= 8)
+            crc = (crc << 8) ^ t[0][(crc >> 24) ^ (length & 0xFF)];
+        return ~crc;
+    }
+}
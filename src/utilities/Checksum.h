@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Checksum
+{
+    // The CRC computed by the POSIX "cksum" command (which populate_assets.sh uses),
+    // so that checksums computed at build time can be checked at runtime.
+    uint32_t PosixCksum(const void *data, size_t size);
+}
@@ -0,0 +1,21 @@
+#include "CpuUsage.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace CpuUsage
+{
+    double ProcessCpuSeconds()
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0.;
+        auto seconds = [](const timeval &t) { return (double)t.tv_sec + (double)t.tv_usec / 1e6; };
+        return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#else
+        return 0.;
+#endif
+    }
+}
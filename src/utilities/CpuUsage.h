@@ -0,0 +1,9 @@
+#pragma once
+
+// Process cpu figures, used by the performance report and the benchmarks.
+// They return 0 when not available on the current platform.
+namespace CpuUsage
+{
+    // User + system cpu time of the process (all its threads), since it started
+    double ProcessCpuSeconds();
+}
@@ -0,0 +1,356 @@
+#include "FontAtlasCache.h"
+#include "Checksum.h"
+#include "hello_imgui/hello_imgui.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+// The version of the manual (see src/CMakeLists.txt): it changes with the fonts it bundles
+#ifndef IMGUI_MANUAL_VERSION
+#define IMGUI_MANUAL_VERSION "dev"
+#endif
+
+namespace FontAtlasCache
+{
+    namespace
+    {
+        /*
+         Format of the cache file (native endianness: it is only read by the same build of the manual)
+             "IMFATLAS", u32 kFormatVersion, u32 key (see ComputeKey)
+             i32 texWidth, i32 texHeight, ImVec2 texUvWhitePixel, ImVec4 texUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1]
+             i32 packIdMouseCursors, i32 packIdLines
+             u32 nbCustomRects, ImFontAtlasCustomRect[nbCustomRects] (their Font is null)
+             u32 nbFonts, nbFonts * (FontHeader, ImFontGlyph[nbGlyphs])
+             u8 alpha8 texture pixels[texWidth * texHeight]
+             u32 cksum of all of the above
+        */
+        constexpr std::string_view kMagic = "IMFATLAS";
+        constexpr uint32_t kFormatVersion = 1;
+
+        struct FontHeader
+        {
+            float fontSize, ascent, descent;
+            ImWchar fallbackChar, ellipsisChar;
+            uint32_t nbGlyphs;
+        };
+
+        Stats gStats;
+
+        template <typename T>
+        void Append(std::string *out, const T &value)
+        {
+            out->append((const char *)&value, sizeof(T));
+        }
+
+        // Reads the cache file, and advances data after what was read
+        class Reader
+        {
+        public:
+            explicit Reader(std::string_view data) : mData(data) {}
+
+            bool readBytes(void *dst, size_t nbBytes)
+            {
+                if (mData.size() < nbBytes)
+                    return false;
+                memcpy(dst, mData.data(), nbBytes);
+                mData.remove_prefix(nbBytes);
+                return true;
+            }
+            template <typename T>
+            bool read(T *value)
+            {
+                return readBytes(value, sizeof(T));
+            }
+
+        private:
+            std::string_view mData;
+        };
+
+        bool ReadFile(const std::string &path, std::string *content)
+        {
+            FILE *f = fopen(path.c_str(), "rb");
+            if (f == nullptr)
+                return false;
+            char buffer[65536];
+            size_t nbRead;
+            while ((nbRead = fread(buffer, 1, sizeof(buffer), f)) > 0)
+                content->append(buffer, nbRead);
+            bool ok = (ferror(f) == 0);
+            fclose(f);
+            return ok;
+        }
+
+        // Writes into a temporary file, renamed at the end: a concurrent launch never reads half a file
+        bool WriteFile(const std::string &path, const std::string &content)
+        {
+            std::string tmpPath = path + ".tmp";
+            FILE *f = fopen(tmpPath.c_str(), "wb");
+            if (f == nullptr)
+                return false;
+            bool ok = (fwrite(content.data(), 1, content.size(), f) == content.size());
+            if (fclose(f) != 0)
+                ok = false;
+            if (ok)
+                ok = (rename(tmpPath.c_str(), path.c_str()) == 0);
+            if (!ok)
+                remove(tmpPath.c_str());
+            return ok;
+        }
+
+        // The size of an asset file, without reading it (0 if unknown)
+        uint64_t AssetFileSize(const std::string &assetPath)
+        {
+            std::error_code error;
+            auto size = std::filesystem::file_size(HelloImGui::assetFileFullPath(assetPath), error);
+            return error ? 0 : (uint64_t)size;
+        }
+
+        // The key changes with anything that changes the atlas: the fonts, the spec, and the version
+        // and layout of ImGui's font structures.
+        // It does not read the fonts: they are identified by their size, and by the version of the manual.
+        uint32_t ComputeKey(const AtlasSpec &spec)
+        {
+            std::string keyData;
+            keyData += IMGUI_MANUAL_VERSION "\n";
+            Append(&keyData, (int)IMGUI_VERSION_NUM);
+            Append(&keyData, sizeof(ImFontGlyph));
+            Append(&keyData, sizeof(ImFontAtlasCustomRect));
+            keyData += spec.textFontPath + "\n" + spec.iconFontPath + "\n";
+            for (ImWchar c : spec.iconRanges)
+                Append(&keyData, c);
+            for (float size : spec.fontSizes)
+                Append(&keyData, size);
+            Append(&keyData, AssetFileSize(spec.textFontPath));
+            Append(&keyData, AssetFileSize(spec.iconFontPath));
+            return Checksum::PosixCksum(keyData.data(), keyData.size());
+        }
+
+        bool SaveAtlas(const ImFontAtlas &atlas, const std::vector<ImFont *> &fonts, uint32_t key,
+                       const std::string &cacheFilePath)
+        {
+            if (atlas.TexPixelsAlpha8 == nullptr)
+                return false;
+            for (const auto &rect : atlas.CustomRects)
+                if (rect.Font != nullptr) // custom glyphs would point to a font
+                    return false;
+
+            std::string out(kMagic);
+            Append(&out, kFormatVersion);
+            Append(&out, key);
+            Append(&out, atlas.TexWidth);
+            Append(&out, atlas.TexHeight);
+            Append(&out, atlas.TexUvWhitePixel);
+            Append(&out, atlas.TexUvLines);
+            Append(&out, atlas.PackIdMouseCursors);
+            Append(&out, atlas.PackIdLines);
+            Append(&out, (uint32_t)atlas.CustomRects.Size);
+            for (const auto &rect : atlas.CustomRects)
+                Append(&out, rect);
+            Append(&out, (uint32_t)fonts.size());
+            for (const ImFont *font : fonts)
+            {
+                FontHeader header{font->FontSize, font->Ascent, font->Descent,
+                                  font->FallbackChar, font->EllipsisChar, (uint32_t)font->Glyphs.Size};
+                Append(&out, header);
+                for (const auto &glyph : font->Glyphs)
+                    Append(&out, glyph);
+            }
+            out.append((const char *)atlas.TexPixelsAlpha8, (size_t)atlas.TexWidth * (size_t)atlas.TexHeight);
+            Append(&out, Checksum::PosixCksum(out.data(), out.size()));
+            return WriteFile(cacheFilePath, out);
+        }
+
+        // The atlas is only changed if the whole cache file is valid
+        bool RestoreAtlas(const std::string &cacheFilePath, uint32_t key, ImFontAtlas *atlas, std::vector<ImFont *> *fonts)
+        {
+            std::string content;
+            if (!ReadFile(cacheFilePath, &content) || content.size() < kMagic.size() + sizeof(uint32_t))
+                return false;
+            std::string_view data(content.data(), content.size() - sizeof(uint32_t));
+            uint32_t cksum;
+            memcpy(&cksum, content.data() + data.size(), sizeof(cksum));
+            if (cksum != Checksum::PosixCksum(data.data(), data.size()))
+                return false;
+
+            Reader reader(data);
+            char magic[kMagic.size()];
+            uint32_t formatVersion = 0, fileKey = 0;
+            if (!reader.readBytes(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) != kMagic)
+                return false;
+            if (!reader.read(&formatVersion) || formatVersion != kFormatVersion || !reader.read(&fileKey) || fileKey != key)
+                return false;
+
+            int texWidth = 0, texHeight = 0, packIdMouseCursors = -1, packIdLines = -1;
+            ImVec2 texUvWhitePixel;
+            ImVec4 texUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+            uint32_t nbCustomRects = 0, nbFonts = 0;
+            if (!reader.read(&texWidth) || !reader.read(&texHeight) || !reader.read(&texUvWhitePixel)
+                || !reader.read(&texUvLines) || !reader.read(&packIdMouseCursors) || !reader.read(&packIdLines)
+                || !reader.read(&nbCustomRects))
+                return false;
+            if (texWidth <= 0 || texHeight <= 0 || nbCustomRects > data.size() / sizeof(ImFontAtlasCustomRect))
+                return false;
+            std::vector<ImFontAtlasCustomRect> customRects(nbCustomRects);
+            if (!reader.readBytes(customRects.data(), nbCustomRects * sizeof(ImFontAtlasCustomRect)))
+                return false;
+            if (!reader.read(&nbFonts) || nbFonts > data.size() / sizeof(FontHeader))
+                return false;
+            std::vector<FontHeader> fontHeaders(nbFonts);
+            std::vector<std::vector<ImFontGlyph>> fontGlyphs(nbFonts);
+            for (uint32_t i = 0; i < nbFonts; ++i)
+            {
+                if (!reader.read(&fontHeaders[i]) || fontHeaders[i].nbGlyphs > data.size() / sizeof(ImFontGlyph))
+                    return false;
+                fontGlyphs[i].resize(fontHeaders[i].nbGlyphs);
+                if (!reader.readBytes(fontGlyphs[i].data(), fontGlyphs[i].size() * sizeof(ImFontGlyph)))
+                    return false;
+            }
+            size_t nbPixels = (size_t)texWidth * (size_t)texHeight;
+            auto *pixels = (unsigned char *)IM_ALLOC(nbPixels);
+            if (!reader.readBytes(pixels, nbPixels))
+            {
+                IM_FREE(pixels);
+                return false;
+            }
+
+            atlas->Clear();
+            atlas->TexWidth = texWidth;
+            atlas->TexHeight = texHeight;
+            atlas->TexUvScale = ImVec2(1.f / (float)texWidth, 1.f / (float)texHeight);
+            atlas->TexUvWhitePixel = texUvWhitePixel;
+            memcpy(atlas->TexUvLines, texUvLines, sizeof(texUvLines));
+            atlas->TexPixelsAlpha8 = pixels; // owned by the atlas
+            for (const auto &rect : customRects)
+                atlas->CustomRects.push_back(rect);
+            atlas->PackIdMouseCursors = packIdMouseCursors;
+            atlas->PackIdLines = packIdLines;
+            for (uint32_t i = 0; i < nbFonts; ++i)
+            {
+                ImFont *font = IM_NEW(ImFont);
+                font->FontSize = fontHeaders[i].fontSize;
+                font->Ascent = fontHeaders[i].ascent;
+                font->Descent = fontHeaders[i].descent;
+                font->FallbackChar = fontHeaders[i].fallbackChar;
+                font->EllipsisChar = fontHeaders[i].ellipsisChar;
+                font->ContainerAtlas = atlas;
+                font->Glyphs.reserve((int)fontGlyphs[i].size());
+                for (const auto &glyph : fontGlyphs[i])
+                    font->Glyphs.push_back(glyph);
+                font->BuildLookupTable();
+                atlas->Fonts.push_back(font);
+                fonts->push_back(font);
+            }
+            return true;
+        }
+
+        std::vector<ImFont *> BuildAtlas(const AtlasSpec &spec,
+                                         const HelloImGui::AssetFileData &textFontData,
+                                         const HelloImGui::AssetFileData &iconFontData,
+                                         ImFontAtlas *atlas)
+        {
+            std::vector<ImFont *> fonts;
+            for (float fontSize : spec.fontSizes)
+            {
+                // The font data is freed by LoadFonts, once the atlas is built
+                ImFontConfig textConfig;
+                textConfig.FontDataOwnedByAtlas = false;
+                ImFont *font = atlas->AddFontFromMemoryTTF(textFontData.data, (int)textFontData.dataSize, fontSize,
+                                                           &textConfig, atlas->GetGlyphRangesDefault());
+                ImFontConfig iconConfig;
+                iconConfig.FontDataOwnedByAtlas = false;
+                iconConfig.MergeMode = true;
+                iconConfig.PixelSnapH = true;
+                atlas->AddFontFromMemoryTTF(iconFontData.data, (int)iconFontData.dataSize, fontSize,
+                                            &iconConfig, spec.iconRanges.data());
+                fonts.push_back(font);
+            }
+            atlas->Build();
+            return fonts;
+        }
+
+        void UpdateStats(const ImFontAtlas &atlas, bool wasRestored, double loadMs)
+        {
+            gStats = Stats();
+            gStats.wasRestored = wasRestored;
+            gStats.loadMs = loadMs;
+            gStats.textureWidth = atlas.TexWidth;
+            gStats.textureHeight = atlas.TexHeight;
+            gStats.textureBytes = (size_t)atlas.TexWidth * (size_t)atlas.TexHeight;
+            for (const ImFont *font : atlas.Fonts)
+            {
+                gStats.nbGlyphs += font->Glyphs.Size;
+                gStats.glyphTablesBytes += (size_t)font->Glyphs.Size * sizeof(ImFontGlyph)
+                                           + (size_t)font->IndexAdvanceX.Size * sizeof(float)
+                                           + (size_t)font->IndexLookup.Size * sizeof(ImWchar);
+            }
+        }
+
+        // Decodes one utf8 character, and advances s after it. Returns 0 at the end, or on invalid input
+        unsigned int NextCodepoint(const char **s)
+        {
+            const auto *p = (const unsigned char *)*s;
+            unsigned int c = p[0];
+            int nbBytes = (c < 0x80) ? 1 : ((c >> 5) == 0x6) ? 2 : ((c >> 4) == 0xE) ? 3 : ((c >> 3) == 0x1E) ? 4 : 0;
+            if (c == 0 || nbBytes == 0)
+                return 0;
+            if (nbBytes > 1)
+                c &= (0xFFu >> (nbBytes + 1));
+            for (int i = 1; i < nbBytes; ++i)
+            {
+                if ((p[i] & 0xC0) != 0x80)
+                    return 0;
+                c = (c << 6) | (p[i] & 0x3Fu);
+            }
+            *s += nbBytes;
+            return c;
+        }
+    } // namespace
+
+    std::vector<ImFont *> LoadFonts(const AtlasSpec &spec, const std::string &cacheFilePath)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+        uint32_t key = ComputeKey(spec);
+
+        std::vector<ImFont *> fonts;
+        bool wasRestored = !cacheFilePath.empty() && RestoreAtlas(cacheFilePath, key, atlas, &fonts);
+        if (!wasRestored)
+        {
+            // The TTF fonts are only read when the atlas is built
+            auto textFontData = HelloImGui::LoadAssetFileData(spec.textFontPath.c_str());
+            auto iconFontData = HelloImGui::LoadAssetFileData(spec.iconFontPath.c_str());
+            fonts = BuildAtlas(spec, textFontData, iconFontData, atlas);
+            if (!cacheFilePath.empty() && !SaveAtlas(*atlas, fonts, key, cacheFilePath))
+                fprintf(stderr, "FontAtlasCache: could not write %s\n", cacheFilePath.c_str());
+            // The fonts were rasterized: the TTF data is not needed anymore
+            atlas->ClearInputData();
+            HelloImGui::FreeAssetFileData(&textFontData);
+            HelloImGui::FreeAssetFileData(&iconFontData);
+        }
+
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        UpdateStats(*atlas, wasRestored, loadMs);
+        return fonts;
+    }
+
+    std::vector<ImWchar> GlyphRangesOf(const std::vector<const char *> &utf8Strings)
+    {
+        std::vector<ImWchar> r;
+        for (const char *s : utf8Strings)
+            while (unsigned int c = NextCodepoint(&s))
+            {
+                r.push_back((ImWchar)c);
+                r.push_back((ImWchar)c);
+            }
+        r.push_back(0);
+        return r;
+    }
+
+    Stats GetStats()
+    {
+        return gStats;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "imgui.h"
+#include <string>
+#include <vector>
+
+// FontAtlasCache loads the fonts of the manual into ImGui::GetIO().Fonts.
+// The first time, it rasterizes them and saves the built atlas (texture + glyph tables) into a cache file;
+// the next launches restore the atlas from this file, without reading nor rasterizing any TTF font.
+// The cache file is rebuilt whenever the font files (known by their size and by the version of the manual),
+// the font sizes, their icons or the version of ImGui change.
+namespace FontAtlasCache
+{
+    struct AtlasSpec
+    {
+        std::string textFontPath;      // asset path, e.g. "fonts/DroidSans.ttf"
+        std::string iconFontPath;      // merged into each text font
+        std::vector<ImWchar> iconRanges; // pairs of [first, last] codepoints, zero terminated
+        std::vector<float> fontSizes;
+    };
+
+    // Returns the fonts, one per size in spec.fontSizes.
+    // cacheFilePath may be "" (e.g. when there is no cache directory): the atlas is then always built
+    std::vector<ImFont *> LoadFonts(const AtlasSpec &spec, const std::string &cacheFilePath);
+
+    // Ranges (zero terminated) that contain only the codepoints of some utf8 strings, e.g. {ICON_FA_LINK, ...}
+    std::vector<ImWchar> GlyphRangesOf(const std::vector<const char *> &utf8Strings);
+
+    struct Stats
+    {
+        bool wasRestored = false; // from the cache file
+        double loadMs = 0.;       // time to build or to restore the atlas
+        int textureWidth = 0, textureHeight = 0;
+        size_t textureBytes = 0;     // alpha8 texture
+        size_t glyphTablesBytes = 0;
+        int nbGlyphs = 0;
+    };
+    Stats GetStats();
+}
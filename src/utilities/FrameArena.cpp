@@ -0,0 +1,90 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace FrameArena
+{
+    namespace
+    {
+        constexpr size_t kMinCapacity = 64 * 1024;
+
+        std::unique_ptr<char[]> gBlock;
+        size_t gCapacity = 0;
+        size_t gNbUsedBytes = 0;
+        // The allocations that did not fit in gBlock, freed at the next frame
+        std::vector<std::unique_ptr<char[]>> gOverflowBlocks;
+        size_t gNbOverflowBytes = 0;
+        Stats gPreviousFrameStats;
+    }
+
+    void NewFrame()
+    {
+        size_t nbFrameBytes = gNbUsedBytes + gNbOverflowBytes;
+        gPreviousFrameStats = {nbFrameBytes, gCapacity, (int)gOverflowBlocks.size()};
+        if (!gOverflowBlocks.empty() || !gBlock)
+        {
+            // Grow, so that the next frames fit in the block
+            gCapacity = std::max(kMinCapacity, 2 * nbFrameBytes);
+            gBlock.reset(new char[gCapacity]);
+            gOverflowBlocks.clear();
+        }
+        gNbUsedBytes = 0;
+        gNbOverflowBytes = 0;
+    }
+
+    void *Allocate(size_t nbBytes, size_t alignment)
+    {
+        size_t start = (gNbUsedBytes + alignment - 1) / alignment * alignment;
+        if (gBlock && start + nbBytes <= gCapacity)
+        {
+            gNbUsedBytes = start + nbBytes;
+            return gBlock.get() + start;
+        }
+        gOverflowBlocks.emplace_back(new char[std::max<size_t>(nbBytes, 1)]);
+        gNbOverflowBytes += nbBytes;
+        return gOverflowBlocks.back().get();
+    }
+
+    const char *Format(const char *format, ...)
+    {
+        va_list args, argsCopy;
+        va_start(args, format);
+        va_copy(argsCopy, args);
+        int length = vsnprintf(nullptr, 0, format, args);
+        va_end(args);
+        if (length < 0)
+        {
+            va_end(argsCopy);
+            return "";
+        }
+        char *r = (char *)Allocate((size_t)length + 1, 1);
+        vsnprintf(r, (size_t)length + 1, format, argsCopy);
+        va_end(argsCopy);
+        return r;
+    }
+
+    const char *Concat(std::initializer_list<std::string_view> parts)
+    {
+        size_t length = 0;
+        for (auto part : parts)
+            length += part.size();
+        char *r = (char *)Allocate(length + 1, 1);
+        char *p = r;
+        for (auto part : parts)
+        {
+            memcpy(p, part.data(), part.size());
+            p += part.size();
+        }
+        *p = '\0';
+        return r;
+    }
+
+    Stats GetStats()
+    {
+        return gPreviousFrameStats;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <string_view>
+
+// FrameArena holds the temporary data of the current frame (e.g. the labels of buttons).
+// It is a bump allocator whose memory is reused from one frame to the next: once it has grown
+// to the size of a frame, gui code that uses it makes no heap allocation.
+// What it returns is valid until the next NewFrame(). Use it from the ui thread only.
+namespace FrameArena
+{
+    // Call this once per frame, before the gui functions
+    void NewFrame();
+
+    // alignment must not be greater than alignof(std::max_align_t)
+    void *Allocate(size_t nbBytes, size_t alignment = alignof(std::max_align_t));
+    // printf-like formatting, into a zero terminated string
+    const char *Format(const char *format, ...);
+    // Zero terminated concatenation of some strings
+    const char *Concat(std::initializer_list<std::string_view> parts);
+
+    struct Stats
+    {
+        size_t nbUsedBytes = 0;   // during the previous frame
+        size_t capacityBytes = 0;
+        int nbOverflowBlocks = 0; // during the previous frame (the capacity then grows)
+    };
+    Stats GetStats();
+}
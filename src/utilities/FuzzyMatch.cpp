@@ -0,0 +1,75 @@
+#include "FuzzyMatch.h"
+
+namespace FuzzyMatch
+{
+    namespace
+    {
+        constexpr int kSubstringScore = 100000;
+        constexpr int kWordStartBonus = 30;
+        constexpr int kConsecutiveBonus = 20;
+        constexpr int kMatchScore = 10;
+        constexpr int kMaxGapPenalty = 10;
+
+        bool isWordChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        }
+
+        bool isWordStart(std::string_view text, size_t i)
+        {
+            return i == 0 || !isWordChar(text[i - 1]);
+        }
+
+        bool isWordEnd(std::string_view text, size_t i)
+        {
+            return i == text.size() || !isWordChar(text[i]);
+        }
+    }
+
+    int Score(std::string_view pattern, std::string_view text)
+    {
+        if (pattern.empty())
+            return 0;
+        const int lengthPenalty = (int)text.size();
+
+        size_t position = text.find(pattern);
+        if (position != std::string_view::npos)
+        {
+            int score = kSubstringScore - (int)position - lengthPenalty;
+            if (isWordStart(text, position))
+                score += kWordStartBonus * 10;
+            if (isWordEnd(text, position + pattern.size()))
+                score += kWordStartBonus * 5; // whole word
+            return score;
+        }
+
+        // Greedy subsequence match
+        int score = 0;
+        size_t textIndex = 0;
+        size_t previousMatch = std::string_view::npos;
+        for (char c : pattern)
+        {
+            size_t match = text.find(c, textIndex);
+            if (match == std::string_view::npos)
+                return -1;
+            score += kMatchScore;
+            if (isWordStart(text, match))
+                score += kWordStartBonus;
+            if (previousMatch != std::string_view::npos)
+            {
+                size_t gap = match - previousMatch - 1;
+                if (gap == 0)
+                    score += kConsecutiveBonus;
+                else
+                    score -= (gap < (size_t)kMaxGapPenalty) ? (int)gap : kMaxGapPenalty;
+            }
+            previousMatch = match;
+            textIndex = match + 1;
+        }
+        score -= lengthPenalty;
+        // Keep fuzzy scores positive, and below substring scores
+        if (score < 0)
+            return 0;
+        return score < kSubstringScore / 2 ? score : kSubstringScore / 2;
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <string_view>
+
+// Fuzzy matching, to rank search results (e.g. the demo tags of ImGuiDemoBrowser)
+namespace FuzzyMatch
+{
+    // Returns -1 if the characters of pattern do not appear in order inside text.
+    // Otherwise, returns a score: higher is better. Texts that contain pattern as a substring
+    // always score higher than the other ones; then matches at word starts, consecutive
+    // matches, and shorter texts are preferred.
+    // Both pattern and text are expected to be lowercase.
+    int Score(std::string_view pattern, std::string_view text);
+}
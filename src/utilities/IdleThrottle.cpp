@@ -0,0 +1,243 @@
+#include "IdleThrottle.h"
+#include "CpuUsage.h"
+#include "WorkerPool.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#elif defined(HELLOIMGUI_USE_SDL_OPENGL3) && !defined(IMGUI_MANUAL_HEADLESS)
+#include <SDL.h>
+#define IDLE_THROTTLE_WAITS_SDL_EVENTS
+#endif
+
+namespace IdleThrottle
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // After an input, ImGui may need a few frames to settle (e.g. a new window is sized during its second frame)
+        constexpr int kNbSettleFrames = 3;
+
+        bool gIsEnabled = true;
+        float gIdleFps = 4.f;
+        int gNbFramesUntilIdle = kNbSettleFrames;
+        bool gIsAnimationRequested = false;
+
+        bool gHasDrawListsHash = false;
+        uint64_t gDrawListsHash = 0;
+
+        Stats gStats;
+        bool gHasSecondStarted = false;
+        Clock::time_point gSecondStart;
+        double gSecondStartCpuSeconds = 0.;
+        int gSecondNbFrames = 0;
+
+        // FNV-1a, over 8 bytes words
+        void HashBytes(uint64_t *hash, const void *data, size_t nbBytes)
+        {
+            const unsigned char *bytes = (const unsigned char *)data;
+            size_t i = 0;
+            for (; i + 8 <= nbBytes; i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, bytes + i, 8);
+                *hash = (*hash ^ word) * 1099511628211ULL;
+            }
+            for (; i < nbBytes; ++i)
+                *hash = (*hash ^ bytes[i]) * 1099511628211ULL;
+        }
+
+        // The draw lists of the windows drawn during the previous frame
+        uint64_t HashDrawLists()
+        {
+            ImGuiContext &g = *ImGui::GetCurrentContext();
+            uint64_t hash = 14695981039346656037ULL;
+            for (ImGuiWindow *window : g.Windows)
+            {
+                // A window already drawn during this frame (e.g. the main dock space) has lost its previous draw list
+                if (!window->WasActive || window->LastFrameActive >= g.FrameCount)
+                    continue;
+                const ImDrawList &drawList = *window->DrawList;
+                HashBytes(&hash, drawList.VtxBuffer.Data, (size_t)drawList.VtxBuffer.Size * sizeof(ImDrawVert));
+                HashBytes(&hash, drawList.IdxBuffer.Data, (size_t)drawList.IdxBuffer.Size * sizeof(ImDrawIdx));
+                for (const ImDrawCmd &command : drawList.CmdBuffer)
+                {
+                    HashBytes(&hash, &command.ClipRect, sizeof(command.ClipRect));
+                    HashBytes(&hash, &command.TextureId, sizeof(command.TextureId));
+                    HashBytes(&hash, &command.ElemCount, sizeof(command.ElemCount));
+                }
+            }
+            return hash;
+        }
+
+        bool HasInput()
+        {
+            const ImGuiIO &io = ImGui::GetIO();
+            if (io.MouseDelta.x != 0.f || io.MouseDelta.y != 0.f || io.MouseWheel != 0.f || io.MouseWheelH != 0.f)
+                return true;
+            if (io.InputQueueCharacters.Size > 0)
+                return true;
+            for (bool isDown : io.MouseDown)
+                if (isDown)
+                    return true;
+            for (bool isDown : io.KeysDown)
+                if (isDown)
+                    return true;
+            return false;
+        }
+
+        void UpdateStats()
+        {
+            auto now = Clock::now();
+            if (!gHasSecondStarted)
+            {
+                gHasSecondStarted = true;
+                gSecondStart = now;
+                gSecondStartCpuSeconds = CpuUsage::ProcessCpuSeconds();
+            }
+            ++gSecondNbFrames;
+            double seconds = std::chrono::duration<double>(now - gSecondStart).count();
+            if (seconds < 1.)
+                return;
+            double cpuSeconds = CpuUsage::ProcessCpuSeconds();
+            gStats.fps = (float)((double)gSecondNbFrames / seconds);
+            gStats.cpuPercent = (float)(100. * (cpuSeconds - gSecondStartCpuSeconds) / seconds);
+            gSecondStart = now;
+            gSecondStartCpuSeconds = cpuSeconds;
+            gSecondNbFrames = 0;
+        }
+
+#if defined(__EMSCRIPTEN__)
+        bool gIsBrowserLoopSlowed = false;
+
+        void SetBrowserLoopSlowed(bool isSlowed)
+        {
+            if (isSlowed == gIsBrowserLoopSlowed)
+                return;
+            gIsBrowserLoopSlowed = isSlowed;
+            if (!isSlowed)
+            {
+                emscripten_resume_main_loop();
+                emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+            }
+            else if (gIdleFps > 0.f)
+                emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, (int)(1000.f / gIdleFps));
+            else
+                emscripten_pause_main_loop();
+        }
+
+        // SDL owns the html5 callbacks of these events: plain listeners are added next to them
+        void InstallBrowserWakeUp()
+        {
+            static bool isInstalled = false;
+            if (isInstalled)
+                return;
+            isInstalled = true;
+            EM_ASM({
+                var wakeUp = function() { _IdleThrottle_WakeUp(); };
+                ['mousemove', 'mousedown', 'mouseup', 'wheel', 'keydown', 'keyup', 'touchstart', 'touchmove',
+                 'resize'].forEach(function(eventName) { window.addEventListener(eventName, wakeUp, true); });
+            });
+        }
+#else
+        // Returns when an input event is queued (it stays in the queue), or after timeoutMs (< 0: no timeout)
+        void WaitForEvent(int timeoutMs)
+        {
+#if defined(IDLE_THROTTLE_WAITS_SDL_EVENTS)
+            if (timeoutMs < 0)
+                SDL_WaitEvent(nullptr);
+            else
+                SDL_WaitEventTimeout(nullptr, timeoutMs);
+#else
+            // Without access to the events (e.g. the headless benchmark), the idle period is slept
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs < 0 ? 250 : timeoutMs));
+#endif
+        }
+#endif
+    } // namespace
+
+    double OnNewFrame()
+    {
+        UpdateStats();
+        bool isActive = !gIsEnabled || gIsAnimationRequested || HasInput() || WorkerPool::IsBusy();
+        gIsAnimationRequested = false;
+        if (isActive)
+            gHasDrawListsHash = false; // no need to hash the frames that are active anyway
+        else
+        {
+            uint64_t drawListsHash = HashDrawLists();
+            if (!gHasDrawListsHash || drawListsHash != gDrawListsHash)
+                isActive = true;
+            gHasDrawListsHash = true;
+            gDrawListsHash = drawListsHash;
+        }
+
+        if (isActive)
+            gNbFramesUntilIdle = kNbSettleFrames;
+        else if (gNbFramesUntilIdle > 0)
+            --gNbFramesUntilIdle;
+        gStats.isIdle = (gNbFramesUntilIdle == 0);
+        if (gStats.isIdle)
+            ++gStats.nbIdleFrames;
+        else
+            ++gStats.nbActiveFrames;
+
+#if defined(__EMSCRIPTEN__)
+        InstallBrowserWakeUp();
+        SetBrowserLoopSlowed(gStats.isIdle);
+        return 0.;
+#else
+        if (!gStats.isIdle)
+            return 0.;
+        // The input that ends the wait is handled by the next frame
+        auto start = Clock::now();
+        WaitForEvent(gIdleFps > 0.f ? (int)(1000.f / gIdleFps) : -1);
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+#endif
+    }
+
+    void RequestAnimation()
+    {
+        gIsAnimationRequested = true;
+    }
+
+    void SetEnabled(bool enabled)
+    {
+        gIsEnabled = enabled;
+    }
+
+    bool IsEnabled()
+    {
+        return gIsEnabled;
+    }
+
+    void SetIdleFps(float fps)
+    {
+        gIdleFps = fps;
+    }
+
+    float GetIdleFps()
+    {
+        return gIdleFps;
+    }
+
+    Stats GetStats()
+    {
+        return gStats;
+    }
+}
+
+#if defined(__EMSCRIPTEN__)
+// Called by the input listeners of the browser
+extern "C" EMSCRIPTEN_KEEPALIVE void IdleThrottle_WakeUp()
+{
+    IdleThrottle::RequestAnimation();
+    IdleThrottle::SetBrowserLoopSlowed(false);
+}
+#endif
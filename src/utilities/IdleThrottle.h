@@ -0,0 +1,38 @@
+#pragma once
+
+// IdleThrottle lowers the frame rate of the manual when nothing changes on screen
+// (most of the time, it shows static text).
+//
+// A frame is active when there was some input (mouse, keyboard, text), when a background job runs
+// (see WorkerPool), when some code called RequestAnimation(), or when the previous frame was drawn
+// differently from the one before it (e.g. the animated widgets of ImGui::ShowDemoWindow):
+// the draw lists of the windows are compared through a hash.
+// A few frames after the last active one, the loop becomes idle: each frame then waits for the next
+// input event, or for the idle period (1 / idle fps; with an idle fps of 0, only an input wakes it).
+//
+// On emscripten, the browser main loop cannot block: it is slowed down instead, and input events
+// bring it back to full speed.
+namespace IdleThrottle
+{
+    // Call this once per frame, after ImGui::NewFrame() and before any window of the manual is drawn
+    // (their draw lists still hold the previous frame). When idle, it waits: returns the waited time.
+    double OnNewFrame();
+    // Keeps the loop at full frame rate for the next frames (e.g. while something moves
+    // that is not visible in the draw lists yet)
+    void RequestAnimation();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+    void SetIdleFps(float fps);
+    float GetIdleFps();
+
+    struct Stats
+    {
+        bool isIdle = false;
+        float fps = 0.f;         // over the last second
+        float cpuPercent = 0.f;  // of the process (all its threads), over the last second
+        int nbActiveFrames = 0;  // since the start
+        int nbIdleFrames = 0;
+    };
+    Stats GetStats();
+}
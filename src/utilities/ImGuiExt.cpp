@@ -6,10 +6,10 @@
 
 namespace ImGuiExt
 {
-    bool ClickableText(const std::string &txt)
+    bool ClickableText(const char *txt)
     {
         auto blue = ImGui::GetStyle().Colors[ImGuiCol_ButtonHovered];
-        ImGui::TextColored(blue, "%s", txt.c_str());
+        ImGui::TextColored(blue, "%s", txt);
         if (ImGui::IsItemHovered() || ImGui::IsItemFocused())
             ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
         return (ImGui::IsItemHovered() && ImGui::IsMouseDown(0));
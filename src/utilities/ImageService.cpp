@@ -0,0 +1,289 @@
+#include "ImageService.h"
+#include "WorkerPool.h"
+#include "hello_imgui/hello_imgui.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// stb_image is private to this file (hello_imgui may link its own copy)
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_GIF
+#define STBI_ONLY_BMP
+#include "stb_image.h"
+
+// The headless benchmark (imgui_manual_bench) has no OpenGL context: its textures are only ids
+#ifndef IMGUI_MANUAL_HEADLESS
+#include "hello_imgui/hello_imgui_include_opengl.h"
+#endif
+
+namespace ImageService
+{
+    namespace
+    {
+#ifdef __EMSCRIPTEN__
+        size_t gByteBudget = 16 * 1024 * 1024;
+#else
+        size_t gByteBudget = 64 * 1024 * 1024;
+#endif
+        // Display widths are rounded up to a multiple of this
+        constexpr int kWidthStep = 128;
+
+        struct Texture
+        {
+            ImTextureID textureId = nullptr;
+            int width = 0, height = 0;
+            int lastUsedFrame = 0;
+
+            size_t nbBytes() const { return (size_t)width * (size_t)height * 4; }
+        };
+
+        struct Image
+        {
+            ImVec2 imageSize; // known once decoded
+            std::vector<Texture> textures; // one per decoded width
+            int decodingWidth = 0;         // 0 if no decode is in progress
+            bool hasFailed = false;
+        };
+
+        // The result of a decode job
+        struct DecodedImage
+        {
+            bool isValid = false;
+            int imageWidth = 0, imageHeight = 0;
+            int width = 0, height = 0;
+            std::vector<unsigned char> rgba;
+        };
+
+        std::map<std::string, Image, std::less<>> gImageOfPath;
+        size_t gNbBytes = 0;
+        Stats gStats;
+
+        // Box filter: each pixel is the average of the pixels of the source it covers
+        std::vector<unsigned char> Downscale(const unsigned char *rgba, int width, int height,
+                                             int dstWidth, int dstHeight)
+        {
+            std::vector<unsigned char> r((size_t)dstWidth * (size_t)dstHeight * 4);
+            for (int y = 0; y < dstHeight; ++y)
+            {
+                int y0 = y * height / dstHeight, y1 = std::max(y0 + 1, (y + 1) * height / dstHeight);
+                for (int x = 0; x < dstWidth; ++x)
+                {
+                    int x0 = x * width / dstWidth, x1 = std::max(x0 + 1, (x + 1) * width / dstWidth);
+                    unsigned int sum[4] = {0, 0, 0, 0};
+                    for (int sy = y0; sy < y1; ++sy)
+                        for (int sx = x0; sx < x1; ++sx)
+                            for (int c = 0; c < 4; ++c)
+                                sum[c] += rgba[((size_t)sy * (size_t)width + (size_t)sx) * 4 + (size_t)c];
+                    unsigned int nbPixels = (unsigned int)((x1 - x0) * (y1 - y0));
+                    for (int c = 0; c < 4; ++c)
+                        r[((size_t)y * (size_t)dstWidth + (size_t)x) * 4 + (size_t)c] = (unsigned char)(sum[c] / nbPixels);
+                }
+            }
+            return r;
+        }
+
+        // Runs on a worker thread
+        void Decode(const std::string &assetPath, int maxWidth, DecodedImage *decoded)
+        {
+            auto assetData = HelloImGui::LoadAssetFileData(assetPath.c_str());
+            if (assetData.data == nullptr)
+                return;
+            int width = 0, height = 0;
+            unsigned char *rgba = stbi_load_from_memory(
+                (const stbi_uc *)assetData.data, (int)assetData.dataSize, &width, &height, nullptr, 4);
+            HelloImGui::FreeAssetFileData(&assetData);
+            if (rgba == nullptr)
+                return;
+
+            decoded->isValid = true;
+            decoded->imageWidth = width;
+            decoded->imageHeight = height;
+            if (width > maxWidth)
+            {
+                decoded->width = maxWidth;
+                decoded->height = std::max(1, (int)((int64_t)height * maxWidth / width));
+                decoded->rgba = Downscale(rgba, width, height, decoded->width, decoded->height);
+            }
+            else
+            {
+                decoded->width = width;
+                decoded->height = height;
+                decoded->rgba.assign(rgba, rgba + (size_t)width * (size_t)height * 4);
+            }
+            stbi_image_free(rgba);
+        }
+
+        ImTextureID UploadTexture(const DecodedImage &decoded)
+        {
+#ifdef IMGUI_MANUAL_HEADLESS
+            static intptr_t lastTextureId = 0;
+            (void)decoded;
+            return (ImTextureID)(++lastTextureId);
+#else
+            GLint previousTexture = 0;
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+            GLuint textureId = 0;
+            glGenTextures(1, &textureId);
+            glBindTexture(GL_TEXTURE_2D, textureId);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, decoded.width, decoded.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         decoded.rgba.data());
+            glBindTexture(GL_TEXTURE_2D, (GLuint)previousTexture);
+            return (ImTextureID)(intptr_t)textureId;
+#endif
+        }
+
+        void DeleteTexture(ImTextureID textureId)
+        {
+#ifdef IMGUI_MANUAL_HEADLESS
+            (void)textureId;
+#else
+            GLuint glTextureId = (GLuint)(intptr_t)textureId;
+            glDeleteTextures(1, &glTextureId);
+#endif
+        }
+
+        // Textures used during the current frame are kept: their draw commands are not rendered yet
+        void EvictIfNeeded()
+        {
+            int currentFrame = ImGui::GetFrameCount();
+            while (gNbBytes > gByteBudget)
+            {
+                Image *lruImage = nullptr;
+                size_t lruIndex = 0;
+                for (auto &kv : gImageOfPath)
+                    for (size_t i = 0; i < kv.second.textures.size(); ++i)
+                    {
+                        const Texture &texture = kv.second.textures[i];
+                        if (texture.lastUsedFrame >= currentFrame)
+                            continue;
+                        if (lruImage == nullptr || texture.lastUsedFrame < lruImage->textures[lruIndex].lastUsedFrame)
+                        {
+                            lruImage = &kv.second;
+                            lruIndex = i;
+                        }
+                    }
+                if (lruImage == nullptr)
+                    return;
+                const Texture &texture = lruImage->textures[lruIndex];
+                DeleteTexture(texture.textureId);
+                gNbBytes -= texture.nbBytes();
+                lruImage->textures.erase(lruImage->textures.begin() + (long)lruIndex);
+                gStats.nbEvictions++;
+            }
+        }
+
+        void StartDecode(const std::string &assetPath, Image *image, int width)
+        {
+            image->decodingWidth = width;
+            auto decoded = std::make_shared<DecodedImage>();
+            WorkerPool::Submit(
+                [assetPath, width, decoded] { Decode(assetPath, width, decoded.get()); },
+                [assetPath, decoded] {
+                    // gImageOfPath entries are never removed: the image is still there
+                    Image &image = gImageOfPath[assetPath];
+                    image.decodingWidth = 0;
+                    gStats.nbDecodes++;
+                    if (!decoded->isValid)
+                    {
+                        image.hasFailed = true;
+                        gStats.nbFailures++;
+                        fprintf(stderr, "ImageService: cannot decode %s\n", assetPath.c_str());
+                        return;
+                    }
+                    image.imageSize = ImVec2((float)decoded->imageWidth, (float)decoded->imageHeight);
+                    Texture texture;
+                    texture.textureId = UploadTexture(*decoded);
+                    texture.width = decoded->width;
+                    texture.height = decoded->height;
+                    texture.lastUsedFrame = ImGui::GetFrameCount();
+                    gNbBytes += texture.nbBytes();
+                    image.textures.push_back(texture);
+                    EvictIfNeeded();
+                });
+        }
+
+        // The width at which an image is decoded for displayWidth
+        int DecodeWidth(const Image &image, float displayWidth)
+        {
+            int width = std::max(1, ((int)displayWidth + kWidthStep - 1) / kWidthStep) * kWidthStep;
+            if (image.imageSize.x > 0.f)
+                width = std::min(width, (int)image.imageSize.x);
+            return width;
+        }
+    } // namespace
+
+    bool GetTexture(std::string_view assetPath, float displayWidth, TextureInfo *textureInfo)
+    {
+        auto it = gImageOfPath.find(assetPath);
+        if (it == gImageOfPath.end())
+            it = gImageOfPath.emplace(std::string(assetPath), Image()).first;
+        Image &image = it->second;
+        if (image.hasFailed)
+            return false;
+
+        int width = DecodeWidth(image, displayWidth);
+        Texture *bestTexture = nullptr;
+        for (auto &texture : image.textures)
+            if (bestTexture == nullptr || texture.width == width
+                || (bestTexture->width != width && texture.width > bestTexture->width))
+                bestTexture = &texture;
+        bool hasWidth = (bestTexture != nullptr && bestTexture->width == width);
+        if (!hasWidth && image.decodingWidth == 0)
+            StartDecode(it->first, &image, width);
+        if (bestTexture == nullptr)
+            return false;
+
+        bestTexture->lastUsedFrame = ImGui::GetFrameCount();
+        textureInfo->textureId = bestTexture->textureId;
+        textureInfo->imageSize = image.imageSize;
+        return true;
+    }
+
+    void ImageFixedWidth(std::string_view assetPath, float width)
+    {
+        TextureInfo texture;
+        if (GetTexture(assetPath, width, &texture))
+        {
+            float height = width * texture.imageSize.y / texture.imageSize.x;
+            ImGui::Image(texture.textureId, ImVec2(width, height));
+        }
+        else
+        {
+            auto it = gImageOfPath.find(assetPath);
+            bool hasFailed = (it != gImageOfPath.end() && it->second.hasFailed);
+            ImGui::TextDisabled("%s %.*s", hasFailed ? "Cannot load" : "Loading", (int)assetPath.size(), assetPath.data());
+        }
+    }
+
+    void SetByteBudget(size_t nbBytes)
+    {
+        gByteBudget = nbBytes;
+        EvictIfNeeded();
+    }
+
+    size_t GetByteBudget()
+    {
+        return gByteBudget;
+    }
+
+    Stats GetStats()
+    {
+        Stats r = gStats;
+        r.nbImages = (int)gImageOfPath.size();
+        for (const auto &kv : gImageOfPath)
+            r.nbTextures += (int)kv.second.textures.size();
+        r.nbBytes = gNbBytes;
+        return r;
+    }
+}
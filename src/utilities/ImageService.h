@@ -0,0 +1,42 @@
+#pragma once
+#include "imgui.h"
+#include <cstddef>
+#include <string_view>
+
+// ImageService is the process wide cache of the images shown by the manual
+// (e.g. diagram.png in the LibrariesCodeBrowser, or the images of the markdown documents).
+// - images are decoded by the WorkerPool, then uploaded as textures on the ui thread
+// - an image is stored downscaled to the width where it is shown (rounded up, so that resizing
+//   a window does not decode it again at each frame), and never above its own size
+// - the textures stay within a byte budget, by evicting those that were used the least recently
+// It shall only be used from the ui thread.
+namespace ImageService
+{
+    struct TextureInfo
+    {
+        ImTextureID textureId = nullptr;
+        ImVec2 imageSize; // size of the image file (the texture itself may be smaller)
+    };
+
+    // assetPath is e.g. "code/imgui_manual/diagram.png".
+    // Returns true if a texture of the image is ready (it may be one of another width, while the image
+    // is decoded again at displayWidth); otherwise starts to decode it, and returns false.
+    bool GetTexture(std::string_view assetPath, float displayWidth, TextureInfo *texture);
+    // Shows the image with the given width (its height keeps the aspect ratio),
+    // or a placeholder text while it is decoded
+    void ImageFixedWidth(std::string_view assetPath, float width);
+
+    void SetByteBudget(size_t nbBytes);
+    size_t GetByteBudget();
+
+    struct Stats
+    {
+        int nbImages = 0;
+        int nbTextures = 0;
+        size_t nbBytes = 0; // of the textures (RGBA)
+        int nbDecodes = 0;
+        int nbFailures = 0;
+        int nbEvictions = 0;
+    };
+    Stats GetStats();
+}
@@ -3,21 +3,48 @@
 #include "imgui_markdown.h"       // https://github.com/juliettef/imgui_markdown
 #include "MarkdownHelper.h"
 #include "HyperlinkHelper.h"
+#include "CacheDir.h"
+#include "FontAtlasCache.h"
+#include "FrameArena.h"
+#include "ImageService.h"
+#include "Profiler.h"
 #include <fplus/fplus.hpp>
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
 namespace MarkdownHelper
 {
 
 ImFont *fontH1, *fontH2, *fontH3;
 
-void LoadFonts()
+FontAtlasCache::AtlasSpec FontAtlasSpec()
 {
-    HelloImGui::ImGuiDefaultSettings::LoadDefaultFont_WithFontAwesomeIcons();
-    std::string fontFilename = "fonts/DroidSans.ttf";
+    FontAtlasCache::AtlasSpec spec;
+    spec.textFontPath = "fonts/DroidSans.ttf";
+    spec.iconFontPath = "fonts/fontawesome-webfont.ttf";
+    // Only the icons used by the manual are rasterized: add new icons here
+    spec.iconRanges = FontAtlasCache::GlyphRangesOf({
+        ICON_FA_ARROW_DOWN, ICON_FA_ARROW_UP, ICON_FA_COPY, ICON_FA_CROSSHAIRS, ICON_FA_CUT, ICON_FA_EDIT, ICON_FA_LINK,
+        ICON_FA_PASTE, ICON_FA_REDO, ICON_FA_SEARCH, ICON_FA_THUMBS_UP, ICON_FA_UNDO});
+    // The default font, then H3, H2 and H1
     float fontSizeStep = 4.;
-    fontH3 = HelloImGui::LoadFontTTF_WithFontAwesomeIcons(fontFilename, 14.f + fontSizeStep * 1.f);
-    fontH2 = HelloImGui::LoadFontTTF_WithFontAwesomeIcons(fontFilename, 14.f + fontSizeStep * 2.f);
-    fontH1 = HelloImGui::LoadFontTTF_WithFontAwesomeIcons(fontFilename, 14.f + fontSizeStep * 3.f);
+    for (int i = 0; i < 4; ++i)
+        spec.fontSizes.push_back(14.f + fontSizeStep * (float)i);
+    return spec;
+}
+
+void LoadFonts()
+{
+    std::string cacheDir = CacheDir::Path();
+    std::string cacheFilePath = cacheDir.empty() ? "" : cacheDir + "/font_atlas.bin";
+    auto fonts = FontAtlasCache::LoadFonts(FontAtlasSpec(), cacheFilePath);
+    fontH3 = fonts[1];
+    fontH2 = fonts[2];
+    fontH1 = fonts[3];
 }
 
 
@@ -29,12 +56,25 @@ void LinkCallback(ImGui::MarkdownLinkCallbackData data_)
         HyperlinkHelper::OpenUrl(url);
 }
 
-inline ImGui::MarkdownImageData ImageCallback(ImGui::MarkdownLinkCallbackData data_)
+// Images are looked for in the asset directory of the document (see Markdown()): images on the web
+// are not downloaded, and imgui_markdown shows their link instead
+ImGui::MarkdownImageData ImageCallback(ImGui::MarkdownLinkCallbackData data_)
 {
-    (void)data_;
-    // In your application you would load an image based on data_ input. Here we just use the imgui font texture.
-    ImTextureID image = ImGui::GetIO().Fonts->TexID;
-    ImGui::MarkdownImageData imageData{true, false, image, ImVec2(40.0f, 20.0f)};
+    ImGui::MarkdownImageData imageData{false, false, nullptr, ImVec2(0.f, 0.f)};
+    const auto *assetDir = (const std::string_view *)data_.userData;
+    std::string_view link(data_.link, (size_t)data_.linkLength);
+    if (assetDir == nullptr || assetDir->empty() || link.find("://") != std::string_view::npos)
+        return imageData;
+
+    const char *assetPath = FrameArena::Concat({*assetDir, "/", link});
+    float availableWidth = ImGui::GetContentRegionAvail().x;
+    ImageService::TextureInfo texture;
+    if (!ImageService::GetTexture(assetPath, availableWidth, &texture))
+        return imageData;
+    float width = std::min(texture.imageSize.x, availableWidth);
+    imageData.isValid = true;
+    imageData.user_texture_id = texture.textureId;
+    imageData.size = ImVec2(width, width * texture.imageSize.y / texture.imageSize.x);
     return imageData;
 }
 
@@ -54,10 +94,173 @@ ImGui::MarkdownConfig factorMarkdownConfig()
 }
 
 
-void Markdown(const std::string &markdown_)
+namespace
 {
+    // Documents below this size are rendered directly
+    constexpr size_t kMinCachedDocumentSize = 2048;
+    // Blocks end at a blank line, once they are at least this long
+    constexpr size_t kMinBlockSize = 256;
+    constexpr size_t kMaxNbCachedDocuments = 32;
+
+    struct Block
+    {
+        size_t offset;
+        size_t length;
+        int nbLines;
+        // Height when the block was last shown, including the spacing after it.
+        // Off-screen blocks keep it, so that it is only an estimate after a change of width.
+        float height = 0.f;
+        bool isMeasured = false;
+    };
+
+    // A document is found by its text buffer, which the callers keep while it is shown (e.g. a Source):
+    // this costs no pass over the text. Since a freed buffer may be reused for another text of the same size,
+    // the hash of the text is checked again whenever a document is shown after it was not shown in the
+    // previous frame.
+    using DocumentKey = std::pair<const char *, size_t>;
+
+    struct CachedDocument
+    {
+        DocumentKey key;
+        size_t textHash;
+        std::vector<Block> blocks;
+        int lastFrame; // when it was last shown
+    };
+
+    // Most recently used first
+    std::list<CachedDocument> gCachedDocuments;
+    std::map<DocumentKey, std::list<CachedDocument>::iterator> gCachedDocumentOfKey;
+    CacheStats gCacheStats;
+    // Blocks rendered and skipped during the current frame, and during the previous one
+    int gCacheStatsFrame = -1;
+    int gNbBlocksRendered = 0, gNbBlocksSkipped = 0;
+
+    std::vector<Block> SplitBlocks(std::string_view markdown)
+    {
+        std::vector<Block> blocks;
+        Block block{0, 0, 0};
+        size_t lineStart = 0;
+        while (lineStart < markdown.size())
+        {
+            size_t lineEnd = markdown.find('\n', lineStart);
+            lineEnd = (lineEnd == std::string_view::npos) ? markdown.size() : lineEnd + 1;
+            bool isBlankLine = markdown.find_first_not_of(" \t\r\n", lineStart) >= lineEnd;
+            block.length = lineEnd - block.offset;
+            ++block.nbLines;
+            if (isBlankLine && block.length >= kMinBlockSize)
+            {
+                blocks.push_back(block);
+                block = Block{lineEnd, 0, 0};
+            }
+            lineStart = lineEnd;
+        }
+        if (block.length > 0)
+            blocks.push_back(block);
+        return blocks;
+    }
+
+    CachedDocument &GetCachedDocument(std::string_view markdown)
+    {
+        DocumentKey key{markdown.data(), markdown.size()};
+        int frame = ImGui::GetFrameCount();
+        auto it = gCachedDocumentOfKey.find(key);
+        if (it != gCachedDocumentOfKey.end())
+        {
+            gCachedDocuments.splice(gCachedDocuments.begin(), gCachedDocuments, it->second);
+            CachedDocument &document = gCachedDocuments.front();
+            bool wasShownLately = document.lastFrame >= frame - 1;
+            document.lastFrame = frame;
+            if (wasShownLately)
+            {
+                ++gCacheStats.nbHits;
+                return document;
+            }
+            size_t textHash = std::hash<std::string_view>()(markdown);
+            if (textHash == document.textHash)
+            {
+                ++gCacheStats.nbHits;
+                return document;
+            }
+            // The buffer now holds another text
+            ++gCacheStats.nbMisses;
+            document.textHash = textHash;
+            document.blocks = SplitBlocks(markdown);
+            return document;
+        }
+
+        ++gCacheStats.nbMisses;
+        gCachedDocuments.push_front({key, std::hash<std::string_view>()(markdown), SplitBlocks(markdown), frame});
+        gCachedDocumentOfKey[key] = gCachedDocuments.begin();
+        if (gCachedDocuments.size() > kMaxNbCachedDocuments)
+        {
+            gCachedDocumentOfKey.erase(gCachedDocuments.back().key);
+            gCachedDocuments.pop_back();
+        }
+        return gCachedDocuments.front();
+    }
+
+    void ResetFrameStatsIfNeeded()
+    {
+        int frame = ImGui::GetFrameCount();
+        if (frame != gCacheStatsFrame)
+        {
+            gCacheStatsFrame = frame;
+            gCacheStats.nbBlocksRendered = gNbBlocksRendered;
+            gCacheStats.nbBlocksSkipped = gNbBlocksSkipped;
+            gNbBlocksRendered = 0;
+            gNbBlocksSkipped = 0;
+        }
+    }
+}
+
+void Markdown(std::string_view markdown_, std::string_view assetDir)
+{
+    Profiler::ScopedTimer scopedTimer("MarkdownHelper::Markdown");
     static ImGui::MarkdownConfig markdownConfig = factorMarkdownConfig();
-    ImGui::Markdown(markdown_.c_str(), markdown_.length(), markdownConfig);
+    markdownConfig.userData = &assetDir; // for ImageCallback
+    if (markdown_.size() < kMinCachedDocumentSize)
+    {
+        ImGui::Markdown(markdown_.data(), markdown_.length(), markdownConfig);
+        return;
+    }
+
+    ResetFrameStatsIfNeeded();
+    CachedDocument &document = GetCachedDocument(markdown_);
+    const float width = ImGui::GetContentRegionAvail().x;
+    for (auto &block : document.blocks)
+    {
+        if (!block.isMeasured)
+            block.height = (float)block.nbLines * ImGui::GetTextLineHeightWithSpacing();
+
+        // Blocks that are out of view are replaced by empty space
+        if (!ImGui::IsRectVisible(ImVec2(width, block.height)))
+        {
+            ImGui::SetCursorPosY(ImGui::GetCursorPosY() + block.height);
+            ++gNbBlocksSkipped;
+            continue;
+        }
+
+        float y = ImGui::GetCursorPosY();
+        ImGui::Markdown(markdown_.data() + block.offset, block.length, markdownConfig);
+        block.height = ImGui::GetCursorPosY() - y;
+        block.isMeasured = true;
+        ++gNbBlocksRendered;
+    }
+}
+
+CacheStats GetCacheStats()
+{
+    ResetFrameStatsIfNeeded();
+    CacheStats r = gCacheStats;
+    r.nbDocuments = (int)gCachedDocuments.size();
+    r.nbBlocks = 0;
+    r.nbBytes = gCachedDocumentOfKey.size() * (sizeof(DocumentKey) + sizeof(void *) * 4);
+    for (const auto &document : gCachedDocuments)
+    {
+        r.nbBlocks += (int)document.blocks.size();
+        r.nbBytes += sizeof(CachedDocument) + sizeof(void *) * 2 + document.blocks.capacity() * sizeof(Block);
+    }
+    return r;
 }
 
 
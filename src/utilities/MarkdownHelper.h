@@ -1,11 +1,33 @@
 #pragma once
 #include "imgui.h"
-#include <string>
+#include "FontAtlasCache.h"
+#include <string_view>
 
 namespace MarkdownHelper
 {
     extern ImFont *fontH1, *fontH2, *fontH3;
 
+    // The default font and the fonts of the titles, with the icons used by the manual
+    FontAtlasCache::AtlasSpec FontAtlasSpec();
+    // Loads them (the atlas is cached between launches, see FontAtlasCache)
     void LoadFonts();
-    void Markdown(const std::string &markdown_);
+
+    // Long documents (README.md, FAQ.md, ...) are split into blocks at blank lines,
+    // and only their visible blocks are rendered: the height of the other blocks
+    // is remembered (or estimated, until they are first shown).
+    // Blocks are cached by the hash of the document content.
+    // Images are read from assetDir (e.g. "code/imgui_manual" for README.md), through the ImageService.
+    void Markdown(std::string_view markdown_, std::string_view assetDir = {});
+
+    struct CacheStats
+    {
+        int nbDocuments = 0;
+        int nbBlocks = 0;
+        size_t nbBytes = 0;       // memory used by the cache (not counting the documents)
+        int nbHits = 0;           // number of calls with a document that was already cached
+        int nbMisses = 0;
+        int nbBlocksRendered = 0; // during the previous frame
+        int nbBlocksSkipped = 0;  // during the previous frame
+    };
+    CacheStats GetCacheStats();
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "MemoryUsage.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace MemoryUsage
+{
+    size_t CurrentRssBytes()
+    {
+#if defined(__linux__)
+        size_t nbPages = 0, nbResidentPages = 0;
+        FILE *f = fopen("/proc/self/statm", "r");
+        if (f == nullptr)
+            return 0;
+        int nbRead = fscanf(f, "%zu %zu", &nbPages, &nbResidentPages);
+        fclose(f);
+        if (nbRead != 2)
+            return 0;
+        return nbResidentPages * (size_t)sysconf(_SC_PAGESIZE);
+#else
+        return 0;
+#endif
+    }
+
+    size_t PeakRssBytes()
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+    #if defined(__APPLE__)
+        return (size_t)usage.ru_maxrss; // bytes on macOS
+    #else
+        return (size_t)usage.ru_maxrss * 1024; // kilobytes on linux
+    #endif
+#else
+        return 0;
+#endif
+    }
+}
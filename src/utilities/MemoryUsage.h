@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+// Process memory figures, used by the performance report.
+// They return 0 when not available on the current platform.
+namespace MemoryUsage
+{
+    size_t CurrentRssBytes();
+    size_t PeakRssBytes();
+}
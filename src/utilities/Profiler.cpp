@@ -0,0 +1,278 @@
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string_view>
+
+namespace Profiler
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr size_t kHistorySize = 300; // frames
+        constexpr size_t kMaxNbTraceEvents = 1000000;
+        constexpr const char *kFrameScopeName = "Frame";
+
+        // The last values of a scope (one per frame), in a ring buffer
+        struct History
+        {
+            std::vector<float> values;
+            size_t next = 0;
+
+            void push(float value)
+            {
+                if (values.size() < kHistorySize)
+                    values.push_back(value);
+                else
+                    values[next] = value;
+                next = (next + 1) % kHistorySize;
+            }
+            float last() const
+            {
+                return values[(next + values.size() - 1) % values.size()];
+            }
+            // Oldest first (reuses the capacity of r)
+            void copyOrderedTo(std::vector<float> *r) const
+            {
+                r->assign(values.begin() + (long)next, values.end());
+                r->insert(r->end(), values.begin(), values.begin() + (long)next);
+            }
+        };
+
+        struct Scope
+        {
+            std::string name;
+            History ms, nbAllocations, allocatedBytes;
+            int lastNbCalls = 0;
+
+            // The current frame
+            double frameMs = 0.;
+            int frameNbCalls = 0;
+            uint64_t frameNbAllocations = 0, frameAllocatedBytes = 0;
+        };
+
+        struct TraceEvent
+        {
+            const Scope *scope;
+            double startUs, durationUs;
+            uint64_t nbAllocations, allocatedBytes;
+        };
+
+        std::vector<std::unique_ptr<Scope>> gScopes; // in creation order
+        std::map<std::string, Scope *, std::less<>> gScopeOfName;
+
+        const Clock::time_point gStartTime = Clock::now();
+        bool gHasFrameStarted = false;
+        Clock::time_point gFrameStart;
+        uint64_t gFrameStartNbAllocations = 0, gFrameStartAllocatedBytes = 0;
+
+        bool gIsTracing = false;
+        std::vector<TraceEvent> gTraceEvents;
+
+        std::vector<float> gSortedMs; // reused by GetScopeStats
+
+        Scope *ScopeOfName(std::string_view name)
+        {
+            auto it = gScopeOfName.find(name);
+            if (it != gScopeOfName.end())
+                return it->second;
+            gScopes.push_back(std::make_unique<Scope>());
+            Scope *scope = gScopes.back().get();
+            scope->name = std::string(name);
+            gScopeOfName[scope->name] = scope;
+            return scope;
+        }
+
+        double Microseconds(Clock::time_point t)
+        {
+            return std::chrono::duration<double, std::micro>(t - gStartTime).count();
+        }
+
+        void AddMeasure(Scope *scope, Clock::time_point start, Clock::time_point end,
+                        uint64_t nbAllocations, uint64_t allocatedBytes)
+        {
+            scope->frameMs += std::chrono::duration<double, std::milli>(end - start).count();
+            scope->frameNbCalls++;
+            scope->frameNbAllocations += nbAllocations;
+            scope->frameAllocatedBytes += allocatedBytes;
+            if (gIsTracing && gTraceEvents.size() < kMaxNbTraceEvents)
+            {
+                double startUs = Microseconds(start);
+                gTraceEvents.push_back({scope, startUs, Microseconds(end) - startUs, nbAllocations, allocatedBytes});
+            }
+        }
+
+        float Percentile(const std::vector<float> &sortedValues, float percent)
+        {
+            if (sortedValues.empty())
+                return 0.f;
+            size_t index = (size_t)(percent / 100.f * (float)(sortedValues.size() - 1) + 0.5f);
+            return sortedValues[index];
+        }
+
+        float Average(const std::vector<float> &values)
+        {
+            if (values.empty())
+                return 0.f;
+            double sum = 0.;
+            for (float v : values)
+                sum += v;
+            return (float)(sum / (double)values.size());
+        }
+
+        void WriteJsonString(FILE *f, const std::string &s)
+        {
+            fputc('"', f);
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\')
+                    fputc('\\', f);
+                if ((unsigned char)c >= 0x20)
+                    fputc(c, f);
+            }
+            fputc('"', f);
+        }
+    }
+
+    ScopedTimer::ScopedTimer(const char *scopeName)
+        : mScopeName(scopeName)
+        , mNbAllocationsAtStart(AllocationCounter::NbAllocations())
+        , mNbAllocatedBytesAtStart(AllocationCounter::NbAllocatedBytes())
+    {
+        mStart = Clock::now();
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        auto end = Clock::now();
+        uint64_t nbAllocations = AllocationCounter::NbAllocations() - mNbAllocationsAtStart;
+        uint64_t allocatedBytes = AllocationCounter::NbAllocatedBytes() - mNbAllocatedBytesAtStart;
+        AddMeasure(ScopeOfName(mScopeName), mStart, end, nbAllocations, allocatedBytes);
+    }
+
+    std::function<void(void)> Wrap(const std::string &scopeName, std::function<void(void)> guiFunction)
+    {
+        return [scopeName, guiFunction] {
+            ScopedTimer scopedTimer(scopeName.c_str());
+            guiFunction();
+        };
+    }
+
+    void DiscardFrame()
+    {
+        gHasFrameStarted = false;
+    }
+
+    void OnNewFrame()
+    {
+        auto now = Clock::now();
+        if (gHasFrameStarted)
+            AddMeasure(ScopeOfName(kFrameScopeName), gFrameStart, now,
+                       AllocationCounter::NbAllocations() - gFrameStartNbAllocations,
+                       AllocationCounter::NbAllocatedBytes() - gFrameStartAllocatedBytes);
+        for (auto &scope : gScopes)
+        {
+            if (scope->frameNbCalls == 0)
+                continue;
+            scope->ms.push((float)scope->frameMs);
+            scope->nbAllocations.push((float)scope->frameNbAllocations);
+            scope->allocatedBytes.push((float)scope->frameAllocatedBytes);
+            scope->lastNbCalls = scope->frameNbCalls;
+            scope->frameMs = 0.;
+            scope->frameNbCalls = 0;
+            scope->frameNbAllocations = 0;
+            scope->frameAllocatedBytes = 0;
+        }
+        gHasFrameStarted = true;
+        gFrameStart = Clock::now();
+        gFrameStartNbAllocations = AllocationCounter::NbAllocations();
+        gFrameStartAllocatedBytes = AllocationCounter::NbAllocatedBytes();
+    }
+
+    void GetScopeStats(std::vector<ScopeStats> *r)
+    {
+        size_t nbStats = 0;
+        for (const auto &scope : gScopes)
+        {
+            if (scope->ms.values.empty())
+                continue;
+            if (r->size() <= nbStats)
+                r->emplace_back();
+            ScopeStats &stats = (*r)[nbStats++];
+            stats.name = scope->name;
+            stats.nbCalls = scope->lastNbCalls;
+            scope->ms.copyOrderedTo(&stats.historyMs);
+            stats.lastMs = scope->ms.last();
+            gSortedMs = scope->ms.values;
+            std::sort(gSortedMs.begin(), gSortedMs.end());
+            stats.p50Ms = Percentile(gSortedMs, 50.f);
+            stats.p95Ms = Percentile(gSortedMs, 95.f);
+            stats.p99Ms = Percentile(gSortedMs, 99.f);
+            stats.maxMs = gSortedMs.back();
+            stats.lastNbAllocations = (uint64_t)scope->nbAllocations.last();
+            stats.nbAllocationsPerFrame = Average(scope->nbAllocations.values);
+            stats.allocatedBytesPerFrame = Average(scope->allocatedBytes.values);
+        }
+        r->resize(nbStats);
+    }
+
+    void ResetStats()
+    {
+        for (auto &scope : gScopes)
+        {
+            scope->ms = History();
+            scope->nbAllocations = History();
+            scope->allocatedBytes = History();
+        }
+    }
+
+    void StartTrace()
+    {
+        gTraceEvents.clear();
+        gTraceEvents.reserve(1 << 16);
+        gIsTracing = true;
+    }
+
+    void StopTrace()
+    {
+        gIsTracing = false;
+    }
+
+    bool IsTracing()
+    {
+        return gIsTracing;
+    }
+
+    size_t NbTraceEvents()
+    {
+        return gTraceEvents.size();
+    }
+
+    bool ExportChromeTrace(const std::string &path)
+    {
+        FILE *f = fopen(path.c_str(), "w");
+        if (f == nullptr)
+            return false;
+        fprintf(f, "{\"traceEvents\":[\n");
+        for (size_t i = 0; i < gTraceEvents.size(); ++i)
+        {
+            const TraceEvent &event = gTraceEvents[i];
+            // Frames are on their own track: their bounds do not nest with the other scopes
+            int trackId = (event.scope->name == kFrameScopeName) ? 0 : 1;
+            fprintf(f, "%s{\"name\":", i > 0 ? ",\n" : "");
+            WriteJsonString(f, event.scope->name);
+            fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                       "\"args\":{\"allocations\":%llu,\"allocated_bytes\":%llu}}",
+                    trackId, event.startUs, event.durationUs,
+                    (unsigned long long)event.nbAllocations, (unsigned long long)event.allocatedBytes);
+        }
+        fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        bool ok = (ferror(f) == 0);
+        if (fclose(f) != 0)
+            ok = false;
+        return ok;
+    }
+}
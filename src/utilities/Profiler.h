@@ -0,0 +1,65 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Profiler measures, frame by frame, the time spent and the heap allocations made
+// in named scopes of the ui thread (e.g. the gui function of each dockable window).
+// See ProfilerWindow.
+//
+// Allocations are counted by AllocationCounter.
+// Scopes may be nested: the figures of a scope include those of its inner scopes.
+namespace Profiler
+{
+    // Measures the scope in which it lives. Use it from the ui thread only.
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char *scopeName);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        const char *mScopeName;
+        std::chrono::steady_clock::time_point mStart;
+        uint64_t mNbAllocationsAtStart;
+        uint64_t mNbAllocatedBytesAtStart;
+    };
+
+    // Returns a function that calls guiFunction inside a ScopedTimer
+    std::function<void(void)> Wrap(const std::string &scopeName, std::function<void(void)> guiFunction);
+
+    // Call this once per frame from the ui thread, before the gui functions
+    void OnNewFrame();
+    // The frame that ends at the next OnNewFrame() is not measured as a whole (its scopes still are),
+    // e.g. when it waited for an input (see IdleThrottle)
+    void DiscardFrame();
+
+    // The figures of a scope, over its last frames (only those where it ran).
+    // The frame itself is a scope named "Frame".
+    struct ScopeStats
+    {
+        std::string name;
+        int nbCalls = 0;              // during the last frame where it ran
+        std::vector<float> historyMs; // oldest first
+        float lastMs = 0.f, p50Ms = 0.f, p95Ms = 0.f, p99Ms = 0.f, maxMs = 0.f;
+        uint64_t lastNbAllocations = 0;    // during the last frame where it ran
+        float nbAllocationsPerFrame = 0.f; // average
+        float allocatedBytesPerFrame = 0.f; // average
+    };
+    // Fills stats, reusing its memory (so that the profiler window does not allocate once it is shown)
+    void GetScopeStats(std::vector<ScopeStats> *stats);
+    void ResetStats();
+
+    // Trace recording: every scope of every frame is recorded as a trace event
+    void StartTrace();
+    void StopTrace();
+    bool IsTracing();
+    size_t NbTraceEvents();
+    // Writes the recorded events in the Chrome trace event format
+    // (open it with chrome://tracing or https://ui.perfetto.dev). Returns false on failure.
+    bool ExportChromeTrace(const std::string &path);
+}
@@ -0,0 +1,350 @@
+#include "TextSearch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define TEXTSEARCH_USE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// AVX2 is compiled with a target attribute, and only used if the cpu supports it
+#define TEXTSEARCH_USE_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__wasm_simd128__)
+#define TEXTSEARCH_USE_SIMD128
+#include <wasm_simd128.h>
+#endif
+
+namespace TextSearch
+{
+    namespace
+    {
+        // Does haystack[i..] start with needle, knowing that its first and last bytes already match?
+        inline bool MatchesInside(const char *candidate, std::string_view needle)
+        {
+            return needle.size() <= 2 || memcmp(candidate + 1, needle.data() + 1, needle.size() - 2) == 0;
+        }
+
+        size_t FindScalarFrom(std::string_view haystack, std::string_view needle, size_t from)
+        {
+            const char first = needle[0];
+            const char last = needle.back();
+            const size_t n = needle.size();
+            const char *data = haystack.data();
+            while (from + n <= haystack.size())
+            {
+                const char *candidate = (const char *)memchr(data + from, first, haystack.size() - n + 1 - from);
+                if (candidate == nullptr)
+                    return std::string_view::npos;
+                if (candidate[n - 1] == last && MatchesInside(candidate, needle))
+                    return (size_t)(candidate - data);
+                from = (size_t)(candidate - data) + 1;
+            }
+            return std::string_view::npos;
+        }
+
+        // Checks the candidates of a block: bit k of mask is set when the first byte of needle
+        // is at offset i + k and its last byte at offset i + k + n - 1
+        inline size_t CheckCandidates(const char *data, size_t i, unsigned mask, std::string_view needle)
+        {
+            while (mask != 0)
+            {
+#if defined(__GNUC__)
+                unsigned bit = (unsigned)__builtin_ctz(mask);
+#else
+                unsigned bit = 0;
+                while (((mask >> bit) & 1u) == 0)
+                    ++bit;
+#endif
+                if (MatchesInside(data + i + bit, needle))
+                    return i + bit;
+                mask &= mask - 1;
+            }
+            return std::string_view::npos;
+        }
+
+#ifdef TEXTSEARCH_USE_SSE2
+        size_t FindSse2(std::string_view haystack, std::string_view needle)
+        {
+            const size_t n = needle.size();
+            const char *data = haystack.data();
+            const __m128i first = _mm_set1_epi8(needle[0]);
+            const __m128i last = _mm_set1_epi8(needle.back());
+            size_t i = 0;
+            for (; i + n - 1 + 16 <= haystack.size(); i += 16)
+            {
+                __m128i blockFirst = _mm_loadu_si128((const __m128i *)(data + i));
+                __m128i blockLast = _mm_loadu_si128((const __m128i *)(data + i + n - 1));
+                __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last));
+                unsigned mask = (unsigned)_mm_movemask_epi8(eq);
+                size_t found = CheckCandidates(data, i, mask, needle);
+                if (found != std::string_view::npos)
+                    return found;
+            }
+            return FindScalarFrom(haystack, needle, i);
+        }
+#endif
+
+#ifdef TEXTSEARCH_USE_AVX2
+        __attribute__((target("avx2")))
+        size_t FindAvx2(std::string_view haystack, std::string_view needle)
+        {
+            const size_t n = needle.size();
+            const char *data = haystack.data();
+            const __m256i first = _mm256_set1_epi8(needle[0]);
+            const __m256i last = _mm256_set1_epi8(needle.back());
+            size_t i = 0;
+            for (; i + n - 1 + 32 <= haystack.size(); i += 32)
+            {
+                __m256i blockFirst = _mm256_loadu_si256((const __m256i *)(data + i));
+                __m256i blockLast = _mm256_loadu_si256((const __m256i *)(data + i + n - 1));
+                __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last));
+                unsigned mask = (unsigned)_mm256_movemask_epi8(eq);
+                size_t found = CheckCandidates(data, i, mask, needle);
+                if (found != std::string_view::npos)
+                    return found;
+            }
+            return FindScalarFrom(haystack, needle, i);
+        }
+#endif
+
+#ifdef TEXTSEARCH_USE_SIMD128
+        size_t FindSimd128(std::string_view haystack, std::string_view needle)
+        {
+            const size_t n = needle.size();
+            const char *data = haystack.data();
+            const v128_t first = wasm_i8x16_splat(needle[0]);
+            const v128_t last = wasm_i8x16_splat(needle.back());
+            size_t i = 0;
+            for (; i + n - 1 + 16 <= haystack.size(); i += 16)
+            {
+                v128_t blockFirst = wasm_v128_load(data + i);
+                v128_t blockLast = wasm_v128_load(data + i + n - 1);
+                v128_t eq = wasm_v128_and(wasm_i8x16_eq(blockFirst, first), wasm_i8x16_eq(blockLast, last));
+                unsigned mask = (unsigned)wasm_i8x16_bitmask(eq);
+                size_t found = CheckCandidates(data, i, mask, needle);
+                if (found != std::string_view::npos)
+                    return found;
+            }
+            return FindScalarFrom(haystack, needle, i);
+        }
+#endif
+
+        using FindFunction = size_t (*)(std::string_view, std::string_view);
+
+        struct FindImplementation
+        {
+            FindFunction find;
+            const char *name;
+        };
+
+        FindImplementation SelectFindImplementation()
+        {
+#ifdef TEXTSEARCH_USE_AVX2
+            if (__builtin_cpu_supports("avx2"))
+                return {FindAvx2, "avx2"};
+#endif
+#ifdef TEXTSEARCH_USE_SSE2
+            return {FindSse2, "sse2"};
+#elif defined(TEXTSEARCH_USE_SIMD128)
+            return {FindSimd128, "simd128"};
+#else
+            return {FindScalar, "scalar"};
+#endif
+        }
+
+        const FindImplementation &GetFindImplementation()
+        {
+            static FindImplementation implementation = SelectFindImplementation();
+            return implementation;
+        }
+
+        inline bool IsBlank(char c) { return c == ' ' || c == '\t'; }
+    } // namespace
+
+
+    std::string ToLower(std::string_view s)
+    {
+        std::string r(s);
+        for (auto &c : r)
+            if (c >= 'A' && c <= 'Z')
+                c = (char)(c - 'A' + 'a');
+        return r;
+    }
+
+    size_t FindScalar(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.empty())
+            return 0;
+        return FindScalarFrom(haystack, needle, 0);
+    }
+
+    size_t Find(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.empty())
+            return 0;
+        if (needle.size() > haystack.size())
+            return std::string_view::npos;
+        // memchr is already vectorized, and there is no last byte to check
+        if (needle.size() == 1)
+        {
+            const void *found = memchr(haystack.data(), needle[0], haystack.size());
+            return found ? (size_t)((const char *)found - haystack.data()) : std::string_view::npos;
+        }
+        return GetFindImplementation().find(haystack, needle);
+    }
+
+    const char *FindImplementationName()
+    {
+        return GetFindImplementation().name;
+    }
+
+
+    LowercaseDocument::LowercaseDocument(const std::vector<std::string> &lines)
+    {
+        size_t totalSize = 0;
+        for (const auto &line : lines)
+            totalSize += line.size() + 1;
+        mText.resize(totalSize);
+        mLineOffsets.reserve(lines.size() + 1);
+        char *out = &mText[0];
+        size_t offset = 0;
+        for (const auto &line : lines)
+        {
+            mLineOffsets.push_back(offset);
+            memcpy(out + offset, line.data(), line.size());
+            offset += line.size();
+            out[offset++] = '\n';
+        }
+        mLineOffsets.push_back(offset);
+        // Branchless, so that the compiler can vectorize it
+        for (size_t i = 0; i < totalSize; ++i)
+            out[i] = (char)(out[i] + (((unsigned char)(out[i] - 'A') < 26) ? 32 : 0));
+    }
+
+    LowercaseDocument::LowercaseDocument(std::string_view text)
+    {
+        mText.resize(text.size() + 1);
+        char *out = &mText[0];
+        memcpy(out, text.data(), text.size());
+        out[text.size()] = '\n';
+        mLineOffsets.push_back(0);
+        for (size_t i = 0; i < mText.size(); ++i)
+        {
+            if (out[i] == '\n')
+                mLineOffsets.push_back(i + 1);
+            else
+                out[i] = (char)(out[i] + (((unsigned char)(out[i] - 'A') < 26) ? 32 : 0));
+        }
+    }
+
+    std::string_view LowercaseDocument::line(int lineIndex) const
+    {
+        size_t start = mLineOffsets[lineIndex];
+        size_t end = mLineOffsets[lineIndex + 1] - 1;
+        return {mText.data() + start, end - start};
+    }
+
+    std::string_view LowercaseDocument::lines(int firstLine, int endLine) const
+    {
+        if (firstLine >= endLine)
+            return {};
+        size_t start = mLineOffsets[firstLine];
+        size_t end = mLineOffsets[endLine] - 1;
+        return {mText.data() + start, end - start};
+    }
+
+    int LowercaseDocument::lineAt(size_t offset, int firstLine) const
+    {
+        auto it = std::upper_bound(mLineOffsets.begin() + firstLine, mLineOffsets.end(), offset);
+        return (int)(it - mLineOffsets.begin()) - 1;
+    }
+
+
+    Filter::Filter(const char *filterText)
+    {
+        // Same parsing as ImGuiTextFilter::Build: split on ',' and trim blanks
+        std::string_view text(filterText);
+        while (true)
+        {
+            size_t comma = text.find(',');
+            std::string_view term = text.substr(0, comma);
+            while (!term.empty() && IsBlank(term.front()))
+                term.remove_prefix(1);
+            while (!term.empty() && IsBlank(term.back()))
+                term.remove_suffix(1);
+            if (!term.empty())
+            {
+                Term t;
+                t.isExclusion = (term[0] == '-');
+                if (t.isExclusion)
+                    term.remove_prefix(1);
+                else
+                    ++mNbInclusions;
+                // A lone "-" is kept (the filter is active), but it excludes nothing
+                t.lowercaseText = ToLower(term);
+                mTerms.push_back(t);
+            }
+            if (comma == std::string_view::npos)
+                break;
+            text.remove_prefix(comma + 1);
+        }
+    }
+
+    bool Filter::passLine(std::string_view lowercaseLine) const
+    {
+        for (const auto &term : mTerms)
+        {
+            if (term.lowercaseText.empty())
+                continue;
+            if (Find(lowercaseLine, term.lowercaseText) != std::string_view::npos)
+                return !term.isExclusion;
+        }
+        return mNbInclusions == 0;
+    }
+
+    void Filter::findMatchingLines(
+        const LowercaseDocument &document, int firstLine, int endLine, std::vector<int> *matchingLines) const
+    {
+        if (firstLine >= endLine)
+            return;
+        const int nbLines = endLine - firstLine;
+        const std::string_view text = document.lines(firstLine, endLine);
+        const size_t textOffset = document.lineOffset(firstLine);
+
+        // For each line, the decision of the first term that matches it (see passLine).
+        // Terms are searched in the whole range at once, which is where SIMD pays off.
+        enum : unsigned char { Undecided, Pass, Reject };
+        std::vector<unsigned char> decisions(nbLines, Undecided);
+        for (const auto &term : mTerms)
+        {
+            if (term.lowercaseText.empty())
+                continue;
+            const unsigned char decision = term.isExclusion ? Reject : Pass;
+            size_t position = 0;
+            int line = firstLine;
+            while (position < text.size())
+            {
+                size_t found = Find(text.substr(position), term.lowercaseText);
+                if (found == std::string_view::npos)
+                    break;
+                line = document.lineAt(textOffset + position + found, line);
+                if (decisions[line - firstLine] == Undecided)
+                    decisions[line - firstLine] = decision;
+                // Other occurrences on the same line do not matter
+                if (line + 1 >= endLine)
+                    break;
+                position = document.lineOffset(line + 1) - textOffset;
+            }
+        }
+
+        const unsigned char noMatchDecision = (mNbInclusions == 0) ? Pass : Reject;
+        for (int i = 0; i < nbLines; ++i)
+        {
+            unsigned char decision = decisions[i] == Undecided ? noMatchDecision : decisions[i];
+            if (decision == Pass)
+                matchingLines->push_back(firstLine + i);
+        }
+    }
+}
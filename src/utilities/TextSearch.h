@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A case insensitive search kernel, equivalent to ImGuiTextFilter::PassFilter
+// but working on a whole document at once:
+// - the document is stored as one contiguous lowercased copy, with a line offset table
+// - each term of the filter is searched in the whole document with SIMD first-byte and
+//   last-byte candidate filtering (AVX2 or SSE2 on x86, SIMD128 on wasm), or a scalar
+//   fallback on other platforms
+namespace TextSearch
+{
+    // A lowercased copy of a text, split into lines
+    class LowercaseDocument
+    {
+    public:
+        LowercaseDocument() = default;
+        explicit LowercaseDocument(const std::vector<std::string> &lines);
+        // The lines of text are separated by '\n'
+        explicit LowercaseDocument(std::string_view text);
+
+        int nbLines() const { return (int)mLineOffsets.size() - 1; }
+        // The lowercased line, without its '\n'
+        std::string_view line(int lineIndex) const;
+        // The lowercased lines [firstLine, endLine), separated by '\n'
+        std::string_view lines(int firstLine, int endLine) const;
+        size_t lineOffset(int lineIndex) const { return mLineOffsets[lineIndex]; }
+        // Index of the line that contains the given offset in the document
+        int lineAt(size_t offset, int firstLine = 0) const;
+
+    private:
+        std::string mText;               // lines separated by '\n'
+        std::vector<size_t> mLineOffsets; // nbLines + 1 entries; the last one is past the end
+    };
+
+    // Same syntax and semantics as ImGuiTextFilter: "-exc,inc".
+    // Terms are checked in order; an exclusion or an inclusion that matches decides,
+    // and a line with no matching term passes only if the filter has no inclusion.
+    class Filter
+    {
+    public:
+        Filter() = default;
+        explicit Filter(const char *filterText);
+
+        // A term of the filter, lowercased, without its '-' (a lone "-" gives an empty exclusion)
+        struct Term
+        {
+            std::string lowercaseText;
+            bool isExclusion = false;
+        };
+        // In the order of the filter text (e.g. for other kinds of matching, such as FuzzyMatch)
+        const std::vector<Term> &terms() const { return mTerms; }
+
+        bool isActive() const { return !mTerms.empty(); }
+        bool passLine(std::string_view lowercaseLine) const;
+        // Appends the indices of the lines in [firstLine, endLine) that pass the filter
+        void findMatchingLines(
+            const LowercaseDocument &document, int firstLine, int endLine, std::vector<int> *matchingLines) const;
+
+    private:
+        std::vector<Term> mTerms;
+        int mNbInclusions = 0;
+    };
+
+    // Lowercases ASCII letters only, like ImStristr
+    std::string ToLower(std::string_view s);
+
+    // Offset of the first occurrence of needle inside haystack, or std::string_view::npos.
+    // The search is case sensitive: lowercase both sides to get a case insensitive search.
+    size_t Find(std::string_view haystack, std::string_view needle);
+    // Find without SIMD, for benchmarks and tests
+    size_t FindScalar(std::string_view haystack, std::string_view needle);
+    // The name of the implementation used by Find ("avx2", "sse2", "simd128" or "scalar")
+    const char *FindImplementationName();
+}
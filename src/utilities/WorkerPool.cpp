@@ -0,0 +1,167 @@
+#include "WorkerPool.h"
+#include "imgui.h"
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define WORKERPOOL_SINGLE_THREADED
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace WorkerPool
+{
+    struct Job
+    {
+        std::function<void()> job;
+        std::function<void()> onDone;
+        int submitFrame = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+#ifdef WORKERPOOL_SINGLE_THREADED
+
+    std::deque<Job> gPendingJobs;
+
+    void Submit(std::function<void()> job, std::function<void()> onDone)
+    {
+        gPendingJobs.push_back({std::move(job), std::move(onDone), ImGui::GetFrameCount()});
+    }
+
+    void ProcessFrame(double timeBudgetMs)
+    {
+        auto start = Clock::now();
+        auto elapsedMs = [start] {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        };
+        // Jobs submitted during this frame wait for the next one, so that
+        // their window can display its "loading" state at least once
+        int currentFrame = ImGui::GetFrameCount();
+        while (!gPendingJobs.empty() && gPendingJobs.front().submitFrame < currentFrame)
+        {
+            Job job = std::move(gPendingJobs.front());
+            gPendingJobs.pop_front();
+            job.job();
+            if (job.onDone)
+                job.onDone();
+            if (elapsedMs() > timeBudgetMs)
+                break;
+        }
+    }
+
+    bool IsBusy()
+    {
+        return !gPendingJobs.empty();
+    }
+
+#else // WORKERPOOL_SINGLE_THREADED
+
+    class ThreadPool
+    {
+    public:
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStop = true;
+            }
+            mCondition.notify_all();
+            for (auto &thread : mThreads)
+                thread.join();
+        }
+
+        void submit(Job job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mThreads.empty())
+                    startThreads();
+                mPendingJobs.push_back(std::move(job));
+            }
+            mCondition.notify_one();
+        }
+
+        std::vector<std::function<void()>> takeDoneCallbacks()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::vector<std::function<void()>> r;
+            std::swap(r, mDoneCallbacks);
+            return r;
+        }
+
+        bool isBusy()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return !mPendingJobs.empty() || mNbRunningJobs > 0 || !mDoneCallbacks.empty();
+        }
+
+    private:
+        void startThreads()
+        {
+            unsigned nbThreads = std::thread::hardware_concurrency();
+            nbThreads = nbThreads > 2 ? nbThreads - 1 : 1;
+            if (nbThreads > 4)
+                nbThreads = 4;
+            for (unsigned i = 0; i < nbThreads; ++i)
+                mThreads.emplace_back([this] { workerLoop(); });
+        }
+
+        void workerLoop()
+        {
+            while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mCondition.wait(lock, [this] { return mStop || !mPendingJobs.empty(); });
+                    if (mStop)
+                        return;
+                    job = std::move(mPendingJobs.front());
+                    mPendingJobs.pop_front();
+                    ++mNbRunningJobs;
+                }
+                job.job();
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    --mNbRunningJobs;
+                    if (job.onDone)
+                        mDoneCallbacks.push_back(std::move(job.onDone));
+                }
+            }
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<Job> mPendingJobs;
+        std::vector<std::function<void()>> mDoneCallbacks;
+        std::vector<std::thread> mThreads;
+        int mNbRunningJobs = 0;
+        bool mStop = false;
+    };
+
+    ThreadPool gThreadPool;
+
+    void Submit(std::function<void()> job, std::function<void()> onDone)
+    {
+        gThreadPool.submit({std::move(job), std::move(onDone), 0});
+    }
+
+    void ProcessFrame(double timeBudgetMs)
+    {
+        (void)timeBudgetMs;
+        for (auto &onDone : gThreadPool.takeDoneCallbacks())
+            onDone();
+    }
+
+    bool IsBusy()
+    {
+        return gThreadPool.isBusy();
+    }
+
+#endif // WORKERPOOL_SINGLE_THREADED
+} // namespace WorkerPool
@@ -0,0 +1,19 @@
+#pragma once
+#include <functional>
+
+// WorkerPool runs jobs (e.g. loading and annotating a source file) outside of the ui thread.
+//
+// On native builds, jobs run on a small pool of threads.
+// On single threaded emscripten builds, jobs are run cooperatively by ProcessFrame(),
+// which will not start more jobs once its time budget is spent.
+namespace WorkerPool
+{
+    // Runs job in the background, then calls onDone on the ui thread (from ProcessFrame)
+    void Submit(std::function<void()> job, std::function<void()> onDone = {});
+
+    // Call this once per frame from the ui thread
+    void ProcessFrame(double timeBudgetMs);
+
+    // True if some jobs are pending, running, or waiting for their onDone callback
+    bool IsBusy();
+}